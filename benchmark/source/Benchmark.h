@@ -0,0 +1,88 @@
+#ifndef _FB_BENCHMARK_H_
+#define _FB_BENCHMARK_H_
+
+#include <FruitBowl.h>
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Prevent the compiler from optimizing away a value
+ *
+ * @param value to keep
+ */
+template <typename T>
+inline void doNotOptimize(const T & value) {
+#ifdef _MSC_VER
+  const volatile void * volatile sink = &value;
+  (void)sink;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * @brief Run a function repeatedly and measure the average duration
+ *
+ * @param iterations number of times to call the function
+ * @param function to call
+ * @return double nanoseconds per iteration
+ */
+template <typename Function>
+double measure(size_t iterations, Function function) {
+  clockHP_t::time_point start = clockHP_t::now();
+  for (size_t i = 0; i < iterations; ++i)
+    function();
+  std::chrono::duration<double, std::nano> elapsed = clockHP_t::now() - start;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Print a benchmark's time per iteration
+ *
+ * @param name of the benchmark
+ * @param nanos per iteration
+ */
+inline void report(const char * name, double nanos) {
+  printf("  %-48s %12.2f ns\n", name, nanos);
+}
+
+/**
+ * @brief Print a benchmark's throughput
+ *
+ * @param name of the benchmark
+ * @param nanos per iteration
+ * @param bytes processed per iteration
+ */
+inline void reportThroughput(const char * name, double nanos, size_t bytes) {
+  printf("  %-48s %12.2f ns %10.2f MB/s\n", name, nanos,
+      static_cast<double>(bytes) * 1e3 / nanos);
+}
+
+void benchmarkBloomFilter();
+void benchmarkChunker();
+void benchmarkCRC32C();
+void benchmarkErrorStorm();
+void benchmarkExpected();
+void benchmarkFile();
+void benchmarkHash();
+void benchmarkHashAlgorithms();
+void benchmarkHashBatch();
+void benchmarkHashIndex();
+void benchmarkHashMap();
+void benchmarkHashQuality();
+void benchmarkInternTable();
+void benchmarkMove();
+void benchmarkPerfectHash();
+void benchmarkReferenceCount();
+void benchmarkResultLog();
+void benchmarkTokenizer();
+void benchmarkUTF8();
+
+#endif /* _FB_BENCHMARK_H_ */
@@ -0,0 +1,65 @@
+#include "Benchmark.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark negative lookups through a Bloom filter against probing a
+ * HashMap, and the false positive rate against bits per key
+ */
+void benchmarkBloomFilter() {
+  const size_t             count = 1 << 20;
+  std::vector<std::string> keys(count);
+  std::vector<std::string> misses(count);
+  std::vector<HashValue_t> hashes(count);
+  std::vector<HashValue_t> missHashes(count);
+  HashMap<uint32_t>        map;
+  for (size_t i = 0; i < count; ++i) {
+    keys[i]       = "key" + std::to_string(i * 2654435761u);
+    misses[i]     = "miss" + std::to_string(i * 2654435761u);
+    hashes[i]     = Hash::calculateHash(keys[i]);
+    missHashes[i] = Hash::calculateHash(misses[i]);
+    map.set(keys[i], static_cast<uint32_t>(i));
+  }
+
+  std::cout << "bloomFilter: 1M keys, 1M unknown keys\n";
+  printf("  %-10s %6s %10s %12s %12s %12s\n", "bits/key", "probes", "size",
+      "false pos", "find ns", "bulk ns");
+  std::unique_ptr<bool[]> results(new bool[count]);
+  for (size_t bitsPerKey = 4; bitsPerKey <= 20; bitsPerKey += 2) {
+    BloomFilter filter(count, bitsPerKey);
+    filter.add(hashes.data(), count);
+    size_t falsePositives =
+        filter.contains(missHashes.data(), count, results.get());
+    double single = measure(3, [&]() {
+      size_t found = 0;
+      for (size_t i = 0; i < count; ++i)
+        found += filter.contains(missHashes[i]);
+      doNotOptimize(found);
+    }) / count;
+    double bulk = measure(3, [&]() {
+      doNotOptimize(filter.contains(missHashes.data(), count, results.get()));
+    }) / count;
+    printf("  %-10zu %6u %8zu KB %11.3f%% %12.2f %12.2f\n", bitsPerKey,
+        filter.getProbes(), filter.getMemoryUsage() >> 10,
+        100.0 * static_cast<double>(falsePositives) / count, single, bulk);
+  }
+
+  BloomFilter filter(count, 10);
+  filter.add(hashes.data(), count);
+  report("HashMap::find unknown key", measure(3, [&]() {
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i)
+      found += map.find(misses[i]) != nullptr;
+    doNotOptimize(found);
+  }) / count);
+  report("BloomFilter then HashMap::find unknown key", measure(3, [&]() {
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+      HashValue_t hash = Hash::calculateHash(misses[i]);
+      found += filter.contains(hash) && map.find(misses[i]) != nullptr;
+    }
+    doNotOptimize(found);
+  }) / count);
+}
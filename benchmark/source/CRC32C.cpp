@@ -0,0 +1,81 @@
+#include "Benchmark.h"
+
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Checksum an array in equal chunks on several threads, combining the
+ * chunks' checksums
+ *
+ * @param c array to checksum
+ * @param length number of characters
+ * @param threadCount number of threads and chunks
+ * @return uint32_t checksum
+ */
+static uint32_t calculateParallel(
+    const char * c, size_t length, unsigned threadCount) {
+  std::vector<uint32_t>    crcs(threadCount);
+  std::vector<std::thread> threads;
+  size_t                   chunk = length / threadCount;
+  for (unsigned i = 0; i < threadCount; ++i) {
+    size_t start = chunk * i;
+    size_t n     = i + 1 == threadCount ? length - start : chunk;
+    threads.push_back(std::thread(
+        [&crcs, c, start, n, i]() { crcs[i] = CRC32C::calculate(c + start, n); }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+
+  uint32_t crc = crcs[0];
+  for (unsigned i = 1; i < threadCount; ++i) {
+    size_t n = i + 1 == threadCount ? length - chunk * i : chunk;
+    crc      = CRC32C::combine(crc, crcs[i], n);
+  }
+  return crc;
+}
+
+/**
+ * @brief Benchmark CRC32C throughput from 8 B to 64 MB, with lookup tables,
+ * with the processor's instructions and on several threads
+ * Each size checksums about 64 MB in total
+ */
+void benchmarkCRC32C() {
+  const size_t      maxSize = 64 << 20;
+  std::vector<char> buffer(maxSize);
+  for (size_t i = 0; i < maxSize; ++i)
+    buffer[i] = static_cast<char>(i * 2654435761u >> 24);
+
+  const size_t sizes[] = {8, 64, 512, 4 << 10, 32 << 10, 256 << 10, 2 << 20,
+      16 << 20, maxSize};
+  std::cout << "crc32c: calculate throughput\n";
+  for (size_t size : sizes) {
+    size_t iterations = maxSize / size;
+    char   name[64];
+
+    snprintf(name, sizeof(name), "CRC32C slicing-by-8 %zu B", size);
+    reportThroughput(name, measure(iterations, [&]() {
+      doNotOptimize(CRC32C::calculateSoftware(buffer.data(), size));
+    }), size);
+
+    snprintf(name, sizeof(name), "CRC32C %zu B", size);
+    reportThroughput(name, measure(iterations, [&]() {
+      doNotOptimize(CRC32C::calculate(buffer.data(), size));
+    }), size);
+  }
+
+  reportThroughput("LiteHash (Jenkins) 64 MB", measure(1, [&]() {
+    LiteHash hash;
+    hash.add(buffer.data(), maxSize);
+    doNotOptimize(hash.get());
+  }), maxSize);
+
+  unsigned threadCount = std::thread::hardware_concurrency();
+  threadCount          = threadCount < 2 ? 2 : threadCount;
+  for (unsigned threads = 2; threads <= threadCount; threads *= 2) {
+    char name[64];
+    snprintf(name, sizeof(name), "CRC32C 64 MB on %u threads", threads);
+    reportThroughput(name, measure(4, [&]() {
+      doNotOptimize(calculateParallel(buffer.data(), maxSize, threads));
+    }), maxSize);
+  }
+}
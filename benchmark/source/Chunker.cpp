@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Benchmark content defined chunking throughput, the distribution of
+ * chunk sizes and the chunks shared after small edits
+ */
+void benchmarkChunker() {
+  const size_t      size = 64 << 20;
+  std::vector<char> buffer(size);
+  uint64_t          state = 1;
+  for (char & c : buffer) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    c     = static_cast<char>(state >> 56);
+  }
+
+  std::cout << "chunker: 64 MB of random characters, 2 KB / 8 KB / 64 KB\n";
+  ChunkBoundaries boundaries(Chunker::MINIMUM, Chunker::AVERAGE,
+      Chunker::MAXIMUM);
+  reportThroughput("ChunkBoundaries find only", measure(3, [&]() {
+    size_t count = 0;
+    for (size_t i = 0; i < size;) {
+      size_t consumed = 0;
+      count += boundaries.find(buffer.data() + i, size - i, consumed);
+      i += consumed;
+    }
+    boundaries.reset();
+    doNotOptimize(count);
+  }), size);
+
+  Chunker chunker;
+  reportThroughput("Chunker (Jenkins)", measure(3, [&]() {
+    HashValue_t sum = 0;
+    auto        add = [&](const Chunker::Chunk & chunk) { sum += chunk.hash; };
+    chunker.add(buffer.data(), size, add);
+    chunker.finish(add);
+    doNotOptimize(sum);
+  }), size);
+
+  ChunkerWy                     chunkerWy;
+  std::vector<ChunkerWy::Chunk> chunks;
+  reportThroughput("Chunker (WyHash)", measure(3, [&]() {
+    chunks.clear();
+    chunkerWy.add(buffer.data(), size, chunks);
+    chunkerWy.finish(chunks);
+  }), size);
+
+  double mean = static_cast<double>(size) / static_cast<double>(chunks.size());
+  double variance = 0;
+  size_t histogram[16] = {};
+  for (const ChunkerWy::Chunk & chunk : chunks) {
+    double difference = static_cast<double>(chunk.length) - mean;
+    variance += difference * difference;
+    size_t bucket = chunk.length / (2 << 10);
+    ++histogram[bucket < 16 ? bucket : 15];
+  }
+  variance /= static_cast<double>(chunks.size());
+  printf("  %zu chunks, mean %.0f B, standard deviation %.0f B\n",
+      chunks.size(), mean, std::sqrt(variance));
+  for (size_t i = 0; i < 16; ++i) {
+    if (i == 15)
+      printf("  %2zu KB and over  %8zu chunks\n", i * 2, histogram[i]);
+    else
+      printf("  %2zu KB to %2zu KB  %8zu chunks\n", i * 2, i * 2 + 2,
+          histogram[i]);
+  }
+
+  // Overwrite 16 bytes every 1 MB, a well deduplicated stream shares most
+  // chunks with the original
+  std::vector<char> edited(buffer);
+  for (size_t i = 512 << 10; i + 16 < size; i += 1 << 20) {
+    for (size_t k = 0; k < 16; ++k)
+      edited[i + k] = 'x';
+  }
+  std::unordered_set<uint64_t> known;
+  for (const ChunkerWy::Chunk & chunk : chunks)
+    known.insert(chunk.hash);
+  std::vector<ChunkerWy::Chunk> editedChunks;
+  chunkerWy.add(edited.data(), size, editedChunks);
+  chunkerWy.finish(editedChunks);
+  size_t newBytes = 0;
+  for (const ChunkerWy::Chunk & chunk : editedChunks) {
+    if (known.count(chunk.hash) == 0)
+      newBytes += chunk.length;
+  }
+  printf("  64 edits of 16 B: %zu B of new chunks (%.2f%%)\n", newBytes,
+      100.0 * static_cast<double>(newBytes) / static_cast<double>(size));
+}
@@ -0,0 +1,89 @@
+#include "Benchmark.h"
+
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fail a three level call stack repeatedly from several threads at once
+ * Each failure appends a message per level, copies the result to a log and
+ * releases it, as every request does when a dependency is down
+ *
+ * @param threadCount number of threads failing
+ * @param failures per thread
+ * @return double total failures per second
+ */
+static double failureThroughput(unsigned threadCount, size_t failures) {
+  std::vector<std::thread> threads;
+  clockHP_t::time_point    start = clockHP_t::now();
+  for (unsigned i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&]() {
+      for (size_t j = 0; j < failures; ++j) {
+        Result result = ResultCode_t::TIMEOUT + "Dependency did not respond";
+        result        = result + "Could not load the user's profile";
+        result        = result + "Could not render the page";
+        Result logged = result;
+        doNotOptimize(logged);
+      }
+      Result::releaseMemory();
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  std::chrono::duration<double> elapsed = clockHP_t::now() - start;
+
+  return static_cast<double>(failures) * threadCount / elapsed.count();
+}
+
+/**
+ * @brief Benchmark the throughput of failing results, each allocating three
+ * message frames, from 1 to 64 threads, then the cost of appending context
+ * formatted eagerly versus deferred, and of a code only failure (counted if
+ * FRUIT_BOWL_RESULT_TELEMETRY is defined)
+ */
+void benchmarkErrorStorm() {
+  std::cout << "errorStorm: failures per second (millions), 3 frames each\n";
+#ifdef FRUIT_BOWL_NO_RESULT_POOL
+  std::cout << "  FRUIT_BOWL_NO_RESULT_POOL defined, global allocator\n";
+#endif /* FRUIT_BOWL_NO_RESULT_POOL */
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  std::cout << "  FRUIT_BOWL_RESULT_TELEMETRY defined, failures counted\n";
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+#ifdef FRUIT_BOWL_NO_THREADS
+  std::cout << "  FRUIT_BOWL_NO_THREADS defined, single thread only\n";
+  const unsigned maxThreads = 1;
+#else
+  const unsigned maxThreads = 64;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  const size_t failures = 200000;
+  printf("  %-8s %16s\n", "threads", "failures");
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    printf("  %-8u %16.2f\n", threads,
+        failureThroughput(threads, failures) / 1e6);
+
+  // A retry loop appending context to each failure then discarding it
+  const size_t iterations = 1000000;
+  int          attempt    = 0;
+  report("Append eager std::string context", measure(iterations, [&]() {
+    Result result = ResultCode_t::TIMEOUT + ("attempt=" +
+                                                std::to_string(++attempt) +
+                                                " host=" + "db-primary");
+    doNotOptimize(result);
+  }));
+  report("Append deferred FB_FORMAT context", measure(iterations, [&]() {
+    Result result = ResultCode_t::TIMEOUT +
+                    FB_FORMAT("attempt={} host={}", ++attempt, "db-primary");
+    doNotOptimize(result);
+  }));
+
+  report("Create code only failure", measure(iterations, [&]() {
+    Result result = ResultCode_t::TIMEOUT;
+    doNotOptimize(result);
+  }));
+
+  Result::MemoryStatistics statistics = Result::getMemoryStatistics();
+  printf("  %zu B in use, %zu B reserved, %zu B high water\n",
+      statistics.inUse, statistics.reserved, statistics.highWater);
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  std::cout << Result::getErrorStatistics();
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Keep each parser a real call so the cost of returning its result is measured
+#ifdef _MSC_VER
+#define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+/**
+ * @brief Parse a decimal port number, failing with only a code
+ *
+ * @param text to parse
+ * @return Expected<uint32_t, ResultCode_t> port or INVALID_DATA
+ */
+BENCHMARK_NOINLINE static Expected<uint32_t, ResultCode_t> parseCode(
+    const std::string & text) {
+  uint32_t port = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9' || port > 6553)
+      return ResultCode_t::INVALID_DATA;
+    port = port * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (text.empty() || port > 65535)
+    return ResultCode_t::INVALID_DATA;
+  return port;
+}
+
+/**
+ * @brief Parse a decimal port number, failing with a message
+ *
+ * @param text to parse
+ * @return Expected<uint32_t> port or INVALID_DATA
+ */
+BENCHMARK_NOINLINE static Expected<uint32_t> parseMessage(
+    const std::string & text) {
+  uint32_t port = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9' || port > 6553)
+      return ResultCode_t::INVALID_DATA + "Port is not a number";
+    port = port * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (text.empty() || port > 65535)
+    return ResultCode_t::INVALID_DATA + "Port is not a number";
+  return port;
+}
+
+/**
+ * @brief Parse a decimal port number into an output parameter
+ *
+ * @param text to parse
+ * @param port output number
+ * @return Result INVALID_DATA if not a port number
+ */
+BENCHMARK_NOINLINE static Result parseOutput(
+    const std::string & text, uint32_t & port) {
+  port = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9' || port > 6553)
+      return ResultCode_t::INVALID_DATA + "Port is not a number";
+    port = port * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (text.empty() || port > 65535)
+    return ResultCode_t::INVALID_DATA + "Port is not a number";
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Parse a decimal port number, throwing on failure
+ *
+ * @param text to parse
+ * @return uint32_t port
+ */
+BENCHMARK_NOINLINE static uint32_t parseThrow(const std::string & text) {
+  uint32_t port = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9' || port > 6553)
+      throw std::invalid_argument("Port is not a number");
+    port = port * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (text.empty() || port > 65535)
+    throw std::invalid_argument("Port is not a number");
+  return port;
+}
+
+/**
+ * @brief Benchmark each way of returning a value or an error from a parser
+ * that is usually called on one of 64 ports
+ *
+ * @param name of the path, success or failure
+ * @param inputs to parse, all valid or all invalid
+ */
+static void benchmarkPath(
+    const char * name, const std::vector<std::string> & inputs) {
+  const size_t iterations = 1000000;
+  const size_t mask       = inputs.size() - 1;
+  size_t       i          = 0;
+  uint32_t     sum        = 0;
+  std::cout << "  " << name << " path\n";
+
+  report("Expected<T, ResultCode_t>", measure(iterations, [&]() {
+    Expected<uint32_t, ResultCode_t> port = parseCode(inputs[i++ & mask]);
+    sum += port ? port.getValue() : 1;
+  }));
+  report("Expected<T> with message", measure(iterations, [&]() {
+    Expected<uint32_t> port = parseMessage(inputs[i++ & mask]);
+    sum += port ? port.getValue() : 1;
+  }));
+  report("Result and output parameter", measure(iterations, [&]() {
+    uint32_t port   = 0;
+    Result   result = parseOutput(inputs[i++ & mask], port);
+    sum += result ? port : 1;
+  }));
+  report("Exception", measure(iterations, [&]() {
+    try {
+      sum += parseThrow(inputs[i++ & mask]);
+    } catch (const std::invalid_argument &) {
+      sum += 1;
+    }
+  }));
+  doNotOptimize(sum);
+}
+
+/**
+ * @brief Benchmark Expected against a Result with an output parameter and
+ * against exceptions, on the success path and the failure path
+ */
+void benchmarkExpected() {
+  std::cout << "expected: parse a port number, sizeof(Expected<uint32_t, "
+               "ResultCode_t>) = "
+            << sizeof(Expected<uint32_t, ResultCode_t>)
+            << ", sizeof(Expected<uint32_t>) = " << sizeof(Expected<uint32_t>)
+            << "\n";
+  std::vector<std::string> valid;
+  std::vector<std::string> invalid;
+  for (uint32_t i = 0; i < 64; ++i) {
+    valid.push_back(std::to_string(1024 + i * 997));
+    invalid.push_back("80" + std::string(1, static_cast<char>('a' + i % 26)));
+  }
+  benchmarkPath("Success", valid);
+  benchmarkPath("Failure", invalid);
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+/**
+ * @brief Benchmark hashing a 256 MB file read into a string versus streamed
+ * in chunks, read or mapped
+ * The file is in the page cache after the first pass, so this measures the
+ * copies and system calls rather than the disk
+ */
+void benchmarkFile() {
+  const std::string path = "FruitBowl-Benchmark-File.bin";
+  const size_t      size = 256 << 20;
+  {
+    std::string contents(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+      contents[i] = static_cast<char>(i * 2654435761u >> 24);
+    std::ofstream(path, std::ios::binary) << contents;
+  }
+
+  std::cout << "file: 256 MB file in the page cache\n";
+  reportThroughput("ifstream to string, WyHash::calculate", measure(3, [&]() {
+    std::ifstream stream(path, std::ios::binary);
+    std::string   contents((std::istreambuf_iterator<char>(stream)),
+        std::istreambuf_iterator<char>());
+    doNotOptimize(WyHash::calculate(contents.c_str(), contents.length()));
+  }), size);
+
+  const File::Access_t accesses[] = {File::Access_t::READ,
+      File::Access_t::MAP};
+  const char *         names[]    = {"read", "map"};
+  for (size_t i = 0; i < 2; ++i) {
+    char name[64];
+    // Touch one character per page so mapped pages are faulted in
+    snprintf(name, sizeof(name), "File::read %s only", names[i]);
+    reportThroughput(name, measure(3, [&]() {
+      size_t total = 0;
+      File::read(
+          path,
+          [](void * context, const char * c, size_t length) {
+            for (size_t k = 0; k < length; k += 4096)
+              *static_cast<size_t *>(context) += static_cast<uint8_t>(c[k]);
+          },
+          &total, accesses[i]);
+      doNotOptimize(total);
+    }), size);
+
+    snprintf(name, sizeof(name), "File::hash<WyHash> %s", names[i]);
+    reportThroughput(name, measure(3, [&]() {
+      uint64_t hash = 0;
+      File::hash<WyHash>(path, hash, accesses[i]);
+      doNotOptimize(hash);
+    }), size);
+
+    snprintf(name, sizeof(name), "File::checksum %s", names[i]);
+    reportThroughput(name, measure(3, [&]() {
+      uint32_t crc = 0;
+      File::checksum(path, crc, accesses[i]);
+      doNotOptimize(crc);
+    }), size);
+  }
+
+  std::remove(path.c_str());
+}
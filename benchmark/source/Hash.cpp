@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark Hash and LiteHash throughput from 8 B to 64 MB
+ * Each size hashes about 64 MB in total
+ */
+void benchmarkHash() {
+  const size_t      maxSize = 64 << 20;
+  std::vector<char> buffer(maxSize);
+  for (size_t i = 0; i < maxSize; ++i)
+    buffer[i] = static_cast<char>(i * 2654435761u >> 24);
+
+  const size_t sizes[] = {8, 64, 512, 4 << 10, 32 << 10, 256 << 10, 2 << 20,
+      16 << 20, maxSize};
+  std::cout << "hash: add(const char *, size_t) throughput\n";
+  for (size_t size : sizes) {
+    size_t iterations = maxSize / size;
+    char   name[64];
+
+    snprintf(name, sizeof(name), "Hash per character %zu B", size);
+    reportThroughput(name, measure(iterations, [&]() {
+      Hash hash;
+      for (size_t i = 0; i < size; ++i)
+        hash.add(buffer[i]);
+      doNotOptimize(hash.get());
+    }), size);
+
+    snprintf(name, sizeof(name), "Hash bulk %zu B", size);
+    reportThroughput(name, measure(iterations, [&]() {
+      Hash hash;
+      hash.add(buffer.data(), size);
+      doNotOptimize(hash.get());
+    }), size);
+
+    snprintf(name, sizeof(name), "LiteHash bulk %zu B", size);
+    reportThroughput(name, measure(iterations, [&]() {
+      LiteHash hash;
+      hash.add(buffer.data(), size);
+      doNotOptimize(hash.get());
+    }), size);
+  }
+}
+
+/**
+ * @brief Benchmark hashing many short independent keys one at a time versus
+ * in vector lanes
+ */
+void benchmarkHashBatch() {
+  const size_t count   = 1 << 20;
+  const size_t sizes[] = {4, 8, 16, 32, 64};
+
+  std::cout << "hashBatch: 1M keys per iteration\n";
+  for (size_t size : sizes) {
+    std::vector<char>         buffer(count * size);
+    std::vector<const char *> keys(count);
+    std::vector<size_t>       lengths(count);
+    std::vector<HashValue_t>  hashes(count);
+    for (size_t i = 0; i < buffer.size(); ++i)
+      buffer[i] = static_cast<char>(i * 2654435761u >> 24);
+    for (size_t i = 0; i < count; ++i) {
+      keys[i]    = buffer.data() + i * size;
+      lengths[i] = size;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "calculateHash %zu B keys", size);
+    reportThroughput(name, measure(10, [&]() {
+      for (size_t i = 0; i < count; ++i) {
+        LiteHash hash;
+        hash.add(keys[i], lengths[i]);
+        hashes[i] = hash.get();
+      }
+      doNotOptimize(hashes.data());
+    }), buffer.size());
+
+    snprintf(name, sizeof(name), "calculateHashes %zu B keys", size);
+    reportThroughput(name, measure(10, [&]() {
+      Hash::calculateHashes(keys.data(), lengths.data(), count, hashes.data());
+      doNotOptimize(hashes.data());
+    }), buffer.size());
+  }
+}
+
+/**
+ * @brief Benchmark one algorithm streaming and one shot for each size
+ *
+ * @tparam Algorithm to benchmark
+ * @param algorithm name to report
+ * @param buffer to hash
+ * @param sizes to hash
+ * @param count number of sizes
+ */
+template <class Algorithm>
+static void benchmarkAlgorithm(const char * algorithm,
+    const std::vector<char> & buffer, const size_t * sizes, size_t count) {
+  for (size_t s = 0; s < count; ++s) {
+    size_t size       = sizes[s];
+    size_t iterations = buffer.size() / size;
+    char   name[64];
+
+    snprintf(name, sizeof(name), "%s streaming %zu B", algorithm, size);
+    reportThroughput(name, measure(iterations, [&]() {
+      BasicLiteHash<Algorithm> hash;
+      hash.add(buffer.data(), size);
+      doNotOptimize(hash.get());
+    }), size);
+
+    snprintf(name, sizeof(name), "%s one shot %zu B", algorithm, size);
+    reportThroughput(name, measure(iterations, [&]() {
+      doNotOptimize(Algorithm::calculate(buffer.data(), size));
+    }), size);
+  }
+}
+
+/**
+ * @brief Benchmark every hash algorithm from 8 B to 16 MB
+ * Each size hashes about 16 MB in total
+ */
+void benchmarkHashAlgorithms() {
+  const size_t      maxSize = 16 << 20;
+  std::vector<char> buffer(maxSize);
+  for (size_t i = 0; i < maxSize; ++i)
+    buffer[i] = static_cast<char>(i * 2654435761u >> 24);
+
+  const size_t sizes[] = {8, 16, 32, 64, 256, 4 << 10, 256 << 10, maxSize};
+  const size_t count   = sizeof(sizes) / sizeof(sizes[0]);
+  std::cout << "hashAlgorithms: streaming and one shot throughput\n";
+  benchmarkAlgorithm<Jenkins>("Jenkins", buffer, sizes, count);
+  benchmarkAlgorithm<XXH64>("XXH64", buffer, sizes, count);
+  benchmarkAlgorithm<WyHash>("WyHash", buffer, sizes, count);
+}
@@ -0,0 +1,65 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark starting up with a persistent hash index against
+ * rebuilding a HashMap, and the lookups of each
+ * The index file is in the page cache, so opening measures the mapping and
+ * checksum rather than the disk
+ */
+void benchmarkHashIndex() {
+  const std::string path  = "FruitBowl-Benchmark-Index.bin";
+  const size_t      count = 1 << 20;
+
+  std::vector<std::string> keys(count);
+  std::vector<std::string> payloads(count);
+  HashIndexBuilder         builder;
+  for (size_t i = 0; i < count; ++i) {
+    keys[i]     = "key" + std::to_string(i * 2654435761u);
+    payloads[i] = "payload" + std::to_string(i);
+    builder.add(keys[i], payloads[i]);
+  }
+  builder.write(path);
+
+  std::cout << "hashIndex: 1M keys, startup then 1M lookups\n";
+  HashMap<std::string> map;
+  report("HashMap rebuild", measure(3, [&]() {
+    map.clear();
+    map.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+      map.set(keys[i], payloads[i]);
+    doNotOptimize(map.size());
+  }));
+
+  HashIndex index;
+  report("HashIndex::open, verified", measure(3, [&]() {
+    index.open(path);
+    doNotOptimize(index.size());
+  }));
+  report("HashIndex::open, header only", measure(3, [&]() {
+    index.open(path, false);
+    doNotOptimize(index.size());
+  }));
+
+  report("HashMap::find", measure(3, [&]() {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i)
+      total += map.find(keys[i])->length();
+    doNotOptimize(total);
+  }) / count);
+  report("HashIndex::find", measure(3, [&]() {
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+      size_t length = 0;
+      index.find(keys[i], length);
+      total += length;
+    }
+    doNotOptimize(total);
+  }) / count);
+
+  index.close();
+  std::remove(path.c_str());
+}
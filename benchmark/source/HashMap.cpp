@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Bytes currently allocated through CountingAllocator
+ */
+static size_t allocatedBytes = 0;
+
+/**
+ * @brief Allocator that tallies the bytes held by a standard container
+ *
+ * @tparam T type to allocate
+ */
+template <typename T>
+struct CountingAllocator {
+  typedef T value_type;
+
+  CountingAllocator() {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &) {}
+
+  T * allocate(size_t n) {
+    allocatedBytes += n * sizeof(T);
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T * p, size_t n) {
+    allocatedBytes -= n * sizeof(T);
+    ::operator delete(p);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U> &) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const CountingAllocator<U> &) const {
+    return false;
+  }
+};
+
+typedef std::unordered_map<std::string, uint64_t, std::hash<std::string>,
+    std::equal_to<std::string>,
+    CountingAllocator<std::pair<const std::string, uint64_t> > >
+    StdMap_t;
+
+/**
+ * @brief Benchmark HashMap against std::unordered_map for insert, hit and miss
+ * latency and memory per entry, keys short enough for std::string to hold
+ * inline
+ */
+void benchmarkHashMap() {
+  const size_t sizes[] = {1 << 10, 1 << 14, 1 << 18, 1 << 20};
+
+  std::cout << "hashMap: uint64_t values, 8-12 B keys\n";
+  for (size_t count : sizes) {
+    std::vector<std::string> keys(count);
+    std::vector<std::string> misses(count);
+    std::vector<Hash>        hashes(count);
+    for (size_t i = 0; i < count; ++i) {
+      keys[i]   = "key" + std::to_string(i * 2654435761u % 1000000000);
+      misses[i] = "miss" + std::to_string(i);
+      hashes[i].add(keys[i]);
+    }
+    size_t iterations = (4 << 20) / count;
+    char   name[64];
+
+    snprintf(name, sizeof(name), "HashMap insert %zu", count);
+    report(name, measure(iterations, [&]() {
+      HashMap<uint64_t> map;
+      for (size_t i = 0; i < count; ++i)
+        map.set(keys[i], i);
+      doNotOptimize(map.size());
+    }) / count);
+
+    snprintf(name, sizeof(name), "std::unordered_map insert %zu", count);
+    report(name, measure(iterations, [&]() {
+      StdMap_t map;
+      for (size_t i = 0; i < count; ++i)
+        map[keys[i]] = i;
+      doNotOptimize(map.size());
+    }) / count);
+
+    HashMap<uint64_t> map;
+    StdMap_t          stdMap;
+    for (size_t i = 0; i < count; ++i) {
+      map.set(keys[i], i);
+      stdMap[keys[i]] = i;
+    }
+
+    snprintf(name, sizeof(name), "HashMap hit %zu", count);
+    report(name, measure(iterations, [&]() {
+      uint64_t sum = 0;
+      for (const std::string & key : keys)
+        sum += *map.find(key);
+      doNotOptimize(sum);
+    }) / count);
+
+    snprintf(name, sizeof(name), "HashMap hit precomputed Hash %zu", count);
+    report(name, measure(iterations, [&]() {
+      uint64_t sum = 0;
+      for (const Hash & hash : hashes)
+        sum += *map.find(hash);
+      doNotOptimize(sum);
+    }) / count);
+
+    snprintf(name, sizeof(name), "std::unordered_map hit %zu", count);
+    report(name, measure(iterations, [&]() {
+      uint64_t sum = 0;
+      for (const std::string & key : keys)
+        sum += stdMap.find(key)->second;
+      doNotOptimize(sum);
+    }) / count);
+
+    snprintf(name, sizeof(name), "HashMap miss %zu", count);
+    report(name, measure(iterations, [&]() {
+      size_t found = 0;
+      for (const std::string & key : misses)
+        found += map.find(key) != nullptr;
+      doNotOptimize(found);
+    }) / count);
+
+    snprintf(name, sizeof(name), "std::unordered_map miss %zu", count);
+    report(name, measure(iterations, [&]() {
+      size_t found = 0;
+      for (const std::string & key : misses)
+        found += stdMap.find(key) != stdMap.end();
+      doNotOptimize(found);
+    }) / count);
+
+    printf("  %-48s %12.2f B\n", "HashMap memory per entry",
+        static_cast<double>(map.getMemoryUsage()) / count);
+    printf("  %-48s %12.2f B (excluding allocator overhead)\n",
+        "std::unordered_map memory per entry",
+        static_cast<double>(sizeof(StdMap_t) + allocatedBytes) / count);
+  }
+}
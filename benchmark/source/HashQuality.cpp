@@ -0,0 +1,275 @@
+#include "Benchmark.h"
+
+#include <CPU.h>
+
+#include <cmath>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifdef FRUIT_BOWL_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Read the time stamp counter
+ * Counts at the nominal frequency, not the boosted core clock
+ *
+ * @return uint64_t cycles, 0 if not available
+ */
+static inline uint64_t readCycles() {
+#ifdef FRUIT_BOWL_X86
+  return __rdtsc();
+#else
+  return 0;
+#endif /* FRUIT_BOWL_X86 */
+}
+
+/**
+ * @brief Named set of keys shaped like real inputs
+ */
+struct Corpus {
+  const char *             name;
+  std::vector<std::string> keys;
+  size_t                   bytes;
+};
+
+/**
+ * @brief Create the key corpora, each of count distinct keys
+ *
+ * @param count number of keys of each corpus
+ * @return std::vector<Corpus>
+ */
+static std::vector<Corpus> makeCorpora(size_t count) {
+  std::vector<Corpus> corpora(4);
+  corpora[0].name = "short IDs";
+  corpora[1].name = "URLs";
+  corpora[2].name = "prefixed numbers";
+  corpora[3].name = "decimal integers";
+  const char digits[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+  for (size_t i = 0; i < count; ++i) {
+    // Identifiers of 1 to 5 characters starting with a letter
+    std::string id(1, digits[i % 26]);
+    for (size_t n = i / 26; n != 0; n /= 37)
+      id += digits[n % 37];
+    corpora[0].keys.push_back(id);
+
+    corpora[1].keys.push_back("https://example.com/api/v2/users/" +
+                              std::to_string(i / 16) + "/orders?page=" +
+                              std::to_string(i % 16));
+
+    char number[32];
+    snprintf(number, sizeof(number), "ORDER-%010zu", i);
+    corpora[2].keys.push_back(number);
+
+    corpora[3].keys.push_back(std::to_string(i));
+  }
+  for (Corpus & corpus : corpora) {
+    corpus.bytes = 0;
+    for (const std::string & key : corpus.keys)
+      corpus.bytes += key.length();
+  }
+  return corpora;
+}
+
+/**
+ * @brief Measure how often each output bit flips when each input bit flips
+ * An ideal hash flips every output bit half the time, the bias of a pair is
+ * |2 * flips / trials - 1|
+ *
+ * @tparam Algorithm to measure
+ * @param length of the random keys
+ * @param trials number of random keys
+ * @param worst output largest bias of any input and output bit pair
+ * @param mean output mean bias
+ */
+template <class Algorithm>
+static void measureAvalanche(
+    size_t length, size_t trials, double & worst, double & mean) {
+  typedef typename Algorithm::Value_t Value_t;
+  const size_t          inputBits  = length * 8;
+  const size_t          outputBits = sizeof(Value_t) * 8;
+  std::vector<uint32_t> flips(inputBits * outputBits, 0);
+  std::string           key(length, '\0');
+  uint64_t              state = 0x2545F4914F6CDD1D;
+  for (size_t t = 0; t < trials; ++t) {
+    for (char & c : key) {
+      state = state * 6364136223846793005 + 1442695040888963407;
+      c     = static_cast<char>(state >> 56);
+    }
+    Value_t base = Algorithm::calculate(key.data(), length);
+    for (size_t i = 0; i < inputBits; ++i) {
+      key[i / 8] ^= static_cast<char>(1 << (i % 8));
+      Value_t difference = base ^ Algorithm::calculate(key.data(), length);
+      key[i / 8] ^= static_cast<char>(1 << (i % 8));
+      for (size_t j = 0; j < outputBits; ++j)
+        flips[i * outputBits + j] += (difference >> j) & 1;
+    }
+  }
+
+  worst = 0;
+  mean  = 0;
+  for (uint32_t count : flips) {
+    double bias = std::fabs(2.0 * count / static_cast<double>(trials) - 1.0);
+    worst       = bias > worst ? bias : worst;
+    mean += bias;
+  }
+  mean /= static_cast<double>(flips.size());
+}
+
+/**
+ * @brief Count keys landing in an occupied bucket when hashing count keys into
+ * count buckets (rounded up to a power of 2)
+ *
+ * @param hashes of each key, folded to 32 bits
+ * @param fibonacci true to pick buckets as HashMap, false by the low bits
+ * @return size_t collisions
+ */
+static size_t countCollisions(
+    const std::vector<HashValue_t> & hashes, bool fibonacci) {
+  size_t buckets = 1;
+  while (buckets < hashes.size())
+    buckets *= 2;
+  std::vector<bool> occupied(buckets, false);
+  size_t            collisions = 0;
+  for (HashValue_t hash : hashes) {
+    size_t i = fibonacci ? static_cast<size_t>((static_cast<uint64_t>(hash) *
+                                                   0x9E3779B97F4A7C15ull) >>
+                                               32) &
+                               (buckets - 1)
+                         : hash & (buckets - 1);
+    collisions += occupied[i];
+    occupied[i] = true;
+  }
+  return collisions;
+}
+
+/**
+ * @brief Insert every hash into a Robin Hood table laid out as HashMap at its
+ * maximum 7/8 load
+ *
+ * @param hashes of each key, folded to 32 bits
+ * @param mean output mean probe distance of a present key, 1 is its home slot
+ * @param longest output longest probe distance
+ */
+static void measureProbes(
+    const std::vector<HashValue_t> & hashes, double & mean, size_t & longest) {
+  size_t capacity = 16;
+  while (hashes.size() * 8 > capacity * 7)
+    capacity *= 2;
+  std::vector<uint32_t> distances(capacity, 0);
+  std::vector<uint32_t> slots(capacity, 0);
+  for (HashValue_t hash : hashes) {
+    HashValue_t value = hash;
+    uint32_t    distance = 1;
+    size_t      i = static_cast<size_t>((static_cast<uint64_t>(value) *
+                                        0x9E3779B97F4A7C15ull) >>
+                                    32) &
+               (capacity - 1);
+    while (distances[i] != 0) {
+      if (distances[i] < distance) {
+        std::swap(distance, distances[i]);
+        std::swap(value, slots[i]);
+      }
+      i = (i + 1) & (capacity - 1);
+      ++distance;
+    }
+    distances[i] = distance;
+    slots[i]     = value;
+  }
+
+  uint64_t total = 0;
+  longest        = 0;
+  for (uint32_t distance : distances) {
+    total += distance;
+    longest = distance > longest ? distance : longest;
+  }
+  mean = static_cast<double>(total) / static_cast<double>(hashes.size());
+}
+
+/**
+ * @brief Analyze one algorithm: avalanche of random keys, then throughput,
+ * collisions and probe lengths of each corpus
+ * Hashes wider than 32 bits are folded to their low 32 bits as HashMap would
+ * store them
+ *
+ * @tparam Algorithm to analyze
+ * @param algorithm name to report
+ * @param corpora to hash
+ */
+template <class Algorithm>
+static void analyzeAlgorithm(
+    const char * algorithm, const std::vector<Corpus> & corpora) {
+  typedef typename Algorithm::Value_t Value_t;
+  printf("  %s\n", algorithm);
+  const size_t lengths[] = {4, 16, 64};
+  for (size_t length : lengths) {
+    double worst = 0;
+    double mean  = 0;
+    measureAvalanche<Algorithm>(length, 4096, worst, mean);
+    printf("    avalanche %2zu B keys: worst bias %.3f, mean bias %.3f\n",
+        length, worst, mean);
+  }
+
+  printf("    %-18s %8s %8s %7s %7s %7s %7s %6s %5s\n", "corpus", "cyc/B",
+      "ns/key", "equal", "low", "fib", "ideal", "probe", "max");
+  for (const Corpus & corpus : corpora) {
+    const std::vector<std::string> & keys = corpus.keys;
+    std::vector<Value_t>             values(keys.size());
+    uint64_t                         cycles = readCycles();
+    double                           nanos  = measure(3, [&]() {
+      for (size_t i = 0; i < keys.size(); ++i)
+        values[i] = Algorithm::calculate(keys[i].data(), keys[i].length());
+      doNotOptimize(values.data());
+    });
+    cycles = (readCycles() - cycles) / 3;
+
+    std::vector<HashValue_t>        hashes(keys.size());
+    std::unordered_set<HashValue_t> unique;
+    unique.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      hashes[i] = static_cast<HashValue_t>(values[i]);
+      unique.insert(hashes[i]);
+    }
+
+    // Expected collisions of a random function into as many buckets
+    double buckets = 1;
+    while (buckets < static_cast<double>(keys.size()))
+      buckets *= 2;
+    double n     = static_cast<double>(keys.size());
+    double ideal = n - buckets * (1 - std::pow(1 - 1 / buckets, n));
+
+    double probe   = 0;
+    size_t longest = 0;
+    measureProbes(hashes, probe, longest);
+    printf("    %-18s %8.2f %8.2f %7zu %7zu %7zu %7.0f %6.3f %5zu\n",
+        corpus.name,
+        static_cast<double>(cycles) / static_cast<double>(corpus.bytes),
+        nanos / n, keys.size() - unique.size(), countCollisions(hashes, false),
+        countCollisions(hashes, true), ideal, probe, longest);
+  }
+}
+
+/**
+ * @brief Analyze the distribution and speed of every hash algorithm on
+ * realistic keys
+ * equal counts keys whose 32-bit hash equals an earlier key's (about 128 are
+ * expected of a random function over 1M keys). low and fib count bucket
+ * collisions into 1M buckets picked by the low bits and by HashMap's
+ * Fibonacci multiply, against the ideal of a random function. probe and max
+ * are the mean and longest Robin Hood probe distances at 7/8 load.
+ */
+void benchmarkHashQuality() {
+  const size_t        count   = 1 << 20;
+  std::vector<Corpus> corpora = makeCorpora(count);
+  std::cout << "hashQuality: 1M keys of each corpus, cycles are time stamp "
+               "counter ticks\n";
+  analyzeAlgorithm<Jenkins>("Jenkins", corpora);
+  analyzeAlgorithm<XXH64>("XXH64", corpora);
+  analyzeAlgorithm<WyHash>("WyHash", corpora);
+}
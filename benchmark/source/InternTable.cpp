@@ -0,0 +1,101 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Intern existing strings repeatedly from several threads at once
+ *
+ * @param table to intern into
+ * @param keys to intern, already interned
+ * @param threadCount number of threads interning
+ * @return double total interns per second
+ */
+static double internThroughput(InternTable & table,
+    const std::vector<std::string> & keys, unsigned threadCount) {
+  std::vector<std::thread> threads;
+
+  clockHP_t::time_point start = clockHP_t::now();
+  for (unsigned i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      for (size_t j = 0; j < keys.size(); ++j) {
+        Hash hash = table.intern(keys[(j + i * 977) % keys.size()]);
+        doNotOptimize(hash);
+      }
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  std::chrono::duration<double> elapsed = clockHP_t::now() - start;
+
+  return static_cast<double>(keys.size()) * threadCount / elapsed.count();
+}
+
+/**
+ * @brief Benchmark interning against owning a copy of each string, for
+ * latency, memory of repeated identifiers, equality and thread scaling
+ */
+void benchmarkInternTable() {
+  const size_t             count = 1 << 16;
+  std::vector<std::string> keys(count);
+  for (size_t i = 0; i < count; ++i)
+    keys[i] = "identifier_" + std::to_string(i * 2654435761u % 1000000);
+
+  std::cout << "internTable: " << count << " distinct 12-17 B strings\n";
+  InternTable table;
+  report("InternTable intern new", measure(1, [&]() {
+    for (const std::string & key : keys)
+      doNotOptimize(table.intern(key));
+  }) / count);
+
+  report("InternTable intern existing", measure(20, [&]() {
+    for (const std::string & key : keys)
+      doNotOptimize(table.intern(key));
+  }) / count);
+
+  report("Hash owning a copy", measure(20, [&]() {
+    for (const std::string & key : keys) {
+      Hash hash;
+      hash.add(key);
+      doNotOptimize(hash);
+    }
+  }) / count);
+
+  std::vector<Hash> owned(count);
+  std::vector<Hash> interned;
+  for (size_t i = 0; i < count; ++i) {
+    owned[i].add(keys[i % 64]);
+    interned.push_back(table.intern(keys[i % 64]));
+  }
+  report("Equality by string compare", measure(20, [&]() {
+    size_t equal = 0;
+    for (size_t i = 1; i < count; ++i)
+      equal += owned[i].getString() == owned[i - 1].getString();
+    doNotOptimize(equal);
+  }) / count);
+
+  report("Equality by interned address", measure(20, [&]() {
+    size_t equal = 0;
+    for (size_t i = 1; i < count; ++i)
+      equal += &interned[i].getString() == &interned[i - 1].getString();
+    doNotOptimize(equal);
+  }) / count);
+
+  printf("  %-48s %12.2f B\n", "InternTable memory per distinct string",
+      static_cast<double>(table.getMemoryUsage()) / table.size());
+  printf("  %-48s %12.2f B\n", "Owned Hash heap per copy (string + count)",
+      static_cast<double>(sizeof(std::string) + sizeof(ReferenceCount)));
+  printf("  %-48s %12.2f B\n", "Interned Hash heap per copy", 0.0);
+
+#ifdef FRUIT_BOWL_NO_THREADS
+  std::cout << "  FRUIT_BOWL_NO_THREADS defined, single thread only\n";
+  const unsigned maxThreads = 1;
+#else
+  const unsigned maxThreads = 64;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  printf("  %-8s %16s\n", "threads", "interns/s (M)");
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    printf("  %-8u %16.2f\n", threads,
+        internThroughput(table, keys, threads) / 1e6);
+}
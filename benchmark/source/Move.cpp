@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Wrapper that hides the move operations of T
+ * Declaring the copy operations suppresses the implicit moves so containers
+ * and returns fall back to copying, like before Result and Hash were movable
+ */
+template <typename T>
+struct CopyOnly {
+  T value;
+
+  CopyOnly(const T & value) : value(value) {}
+  CopyOnly(const CopyOnly & other) : value(other.value) {}
+  CopyOnly & operator=(const CopyOnly & other) {
+    value = other.value;
+    return *this;
+  }
+};
+
+/**
+ * @brief Return an error up a chain of calls
+ * A parameter cannot be elided when returned, it is moved if possible else
+ * copied
+ *
+ * @param depth number of calls remaining
+ * @param error to return
+ * @return R error
+ */
+template <typename R>
+R propagate(int depth, R error) {
+  if (depth == 0)
+    return error;
+  return propagate<R>(depth - 1, std::move(error));
+}
+
+/**
+ * @brief Grow a vector one element at a time, relocating on each reallocation
+ *
+ * @param source elements to append
+ * @return size_t final size
+ */
+template <typename T>
+size_t grow(const std::vector<T> & source) {
+  std::vector<T> vector;
+  for (const T & item : source)
+    vector.push_back(item);
+  doNotOptimize(vector.data());
+  return vector.size();
+}
+
+/**
+ * @brief Benchmark copy versus move of Hash and Result
+ */
+void benchmarkMove() {
+  std::cout << "move: std::vector<Hash> growth, 1000 elements\n";
+  const size_t                 count = 1000;
+  std::vector<Hash>            hashes;
+  std::vector<CopyOnly<Hash> > copyOnlyHashes;
+  for (size_t i = 0; i < count; ++i) {
+    Hash hash;
+    hash.add("key" + std::to_string(i));
+    hashes.push_back(hash);
+    copyOnlyHashes.push_back(CopyOnly<Hash>(hash));
+  }
+  report("copy (before)", measure(2000, [&]() { grow(copyOnlyHashes); }));
+  report("move (after)", measure(2000, [&]() { grow(hashes); }));
+
+  std::cout << "move: Result propagation, 64 calls deep\n";
+  Result error = ResultCode_t::READ_FAULT + "Propagated error";
+  CopyOnly<Result> copyOnlyError(error);
+  report("copy (before)", measure(200000, [&]() {
+    doNotOptimize(propagate<CopyOnly<Result> >(64, copyOnlyError));
+  }));
+  report("move (after)", measure(200000, [&]() {
+    doNotOptimize(propagate<Result>(64, error));
+  }));
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Fixed key set of command verbs and field names
+ */
+static constexpr const char * KEYS[] = {"get", "set", "delete", "list", "help",
+    "quit", "exit", "open", "close", "read", "write", "seek", "flush", "sync",
+    "status", "version", "reset", "start", "stop", "pause", "resume", "info",
+    "debug", "trace", "warning", "error", "id", "name", "type", "value",
+    "length", "offset", "timestamp", "checksum", "parent", "children",
+    "created", "modified", "owner", "group", "permissions", "size", "capacity",
+    "count", "index", "key", "hash", "data", "encoding", "compression",
+    "format", "source", "destination", "priority", "timeout", "retries",
+    "enabled", "visible", "label", "description", "tags", "color", "width",
+    "height"};
+
+/**
+ * @brief Benchmark the perfect hash table against std::unordered_map on the
+ * same keys, for hits and misses
+ */
+void benchmarkPerfectHash() {
+  static constexpr auto TABLE = makePerfectHash(KEYS);
+  static_assert(TABLE.isValid(), "Perfect hash could not place the keys");
+
+  std::unordered_map<std::string, size_t> map;
+  for (size_t i = 0; i < TABLE.size(); ++i)
+    map[KEYS[i]] = i;
+
+  const size_t             count = 1 << 16;
+  std::vector<std::string> hits(count);
+  std::vector<std::string> misses(count);
+  for (size_t i = 0; i < count; ++i) {
+    hits[i]   = KEYS[(i * 2654435761u >> 8) % TABLE.size()];
+    misses[i] = hits[i] + "s";
+  }
+
+  std::cout << "perfectHash: " << TABLE.size() << " keys, " << count
+            << " lookups per iteration\n";
+  const std::vector<std::string> * sets[]  = {&hits, &misses};
+  const char *                     names[] = {"hits", "misses"};
+  for (size_t set = 0; set < 2; ++set) {
+    const std::vector<std::string> & queries = *sets[set];
+    char                             name[64];
+
+    snprintf(name, sizeof(name), "PerfectHash %s", names[set]);
+    report(name, measure(20, [&]() {
+      size_t sum = 0;
+      for (const std::string & query : queries) {
+        size_t index = 0;
+        if (TABLE.find(query, index))
+          sum += index;
+      }
+      doNotOptimize(sum);
+    }) / count);
+
+    snprintf(name, sizeof(name), "std::unordered_map %s", names[set]);
+    report(name, measure(20, [&]() {
+      size_t sum = 0;
+      for (const std::string & query : queries) {
+        std::unordered_map<std::string, size_t>::const_iterator found =
+            map.find(query);
+        if (found != map.end())
+          sum += found->second;
+      }
+      doNotOptimize(sum);
+    }) / count);
+  }
+}
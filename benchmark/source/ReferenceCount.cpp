@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Copy a result repeatedly from several threads at once
+ *
+ * @param threadCount number of threads copying
+ * @param copies per thread
+ * @param shared if true every thread copies the same result (contended
+ * counter), else each thread copies its own
+ * @return double total copies per second
+ */
+static double copyThroughput(
+    unsigned threadCount, size_t copies, bool shared) {
+  Result                   sharedError = ResultCode_t::TIMEOUT + "Contended";
+  std::vector<std::thread> threads;
+
+  clockHP_t::time_point start = clockHP_t::now();
+  for (unsigned i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&]() {
+      Result         ownError = ResultCode_t::TIMEOUT + "Uncontended";
+      const Result & source   = shared ? sharedError : ownError;
+      for (size_t j = 0; j < copies; ++j) {
+        Result copy = source;
+        doNotOptimize(copy);
+      }
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  std::chrono::duration<double> elapsed = clockHP_t::now() - start;
+
+  return static_cast<double>(copies) * threadCount / elapsed.count();
+}
+
+/**
+ * @brief Benchmark Result copy throughput with the reference count shared
+ * between threads versus private to each thread
+ */
+void benchmarkReferenceCount() {
+  std::cout << "referenceCount: Result copies per second (millions)\n";
+#ifdef FRUIT_BOWL_NO_THREADS
+  std::cout << "  FRUIT_BOWL_NO_THREADS defined, single thread only\n";
+  const unsigned maxThreads = 1;
+#else
+  const unsigned maxThreads = 64;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  const size_t copies = 1000000;
+  printf("  %-8s %16s %16s\n", "threads", "contended", "uncontended");
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    printf("  %-8u %16.2f %16.2f\n", threads,
+        copyThroughput(threads, copies, true) / 1e6,
+        copyThroughput(threads, copies, false) / 1e6);
+  }
+}
@@ -0,0 +1,114 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Log results from several threads at once, then wait until every one
+ * is written
+ *
+ * @param log to write to, nullptr to write each to std::cout while locked
+ * @param results to log, each thread cycles through them
+ * @param threadCount number of threads logging
+ * @param count results logged per thread
+ * @param callerNanos output mean nanoseconds a thread spends per result
+ * @return double seconds until every result accepted was written
+ */
+static double logThroughput(ResultLog * log,
+    const std::vector<Result> & results, unsigned threadCount, size_t count,
+    double & callerNanos) {
+  std::mutex               mutex;
+  std::vector<double>      nanos(threadCount);
+  std::vector<std::thread> threads;
+  clockHP_t::time_point    start = clockHP_t::now();
+  for (unsigned i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      nanos[i] = measure(count, [&, j = size_t(0)]() mutable {
+        const Result & result = results[j++ % results.size()];
+        if (log != nullptr) {
+          log->log(result);
+        } else {
+          std::lock_guard<std::mutex> lock(mutex);
+          std::cout << result << '\n';
+        }
+      });
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  if (log != nullptr)
+    log->flush();
+  else
+    std::cout.flush();
+  std::chrono::duration<double> elapsed = clockHP_t::now() - start;
+
+  callerNanos = 0;
+  for (double n : nanos)
+    callerNanos += n / threadCount;
+  return elapsed.count();
+}
+
+/**
+ * @brief Benchmark writing results with ResultLog against writing each to
+ * std::cout on the calling thread, for a failure repeating and for distinct
+ * failures
+ * std::cout is redirected to a file for the duration so the terminal does not
+ * limit either
+ */
+void benchmarkResultLog() {
+  const std::string path = "FruitBowl-Benchmark-Log.txt";
+  std::cout << "resultLog: results written or coalesced per second "
+               "(millions), caller ns per result, "
+            << std::thread::hardware_concurrency() << " CPUs\n";
+  std::vector<Result> repeated(
+      1, ResultCode_t::TIMEOUT + "Database did not respond");
+  std::vector<Result> distinct;
+  for (size_t i = 0; i < 4096; ++i)
+    distinct.push_back(ResultCode_t::OPEN_FAILED +
+                       ("Could not open file " + std::to_string(i)));
+
+  struct Case {
+    const char *                name;
+    const std::vector<Result> * results;
+  };
+  const Case   cases[] = {{"repeated", &repeated}, {"distinct", &distinct}};
+  const size_t count   = 200000;
+  printf("  %-10s %-8s %12s %10s %12s %10s %10s\n", "messages", "threads",
+      "cout", "cout ns", "ResultLog", "log ns", "dropped");
+
+  std::ofstream            file(path, std::ios::binary);
+  std::streambuf *         console = std::cout.rdbuf(file.rdbuf());
+  std::vector<std::string> rows;
+  for (const Case & c : cases) {
+    for (unsigned threads = 1; threads <= 4; threads *= 4) {
+      double syncNanos  = 0;
+      double asyncNanos = 0;
+      double syncSeconds =
+          logThroughput(nullptr, *c.results, threads, count, syncNanos);
+      ResultLog::Statistics statistics;
+      double                asyncSeconds = 0;
+      {
+        ResultLog log(std::cout, 64 * 1024);
+        asyncSeconds =
+            logThroughput(&log, *c.results, threads, count, asyncNanos);
+        statistics = log.getStatistics();
+      }
+      double sync  = static_cast<double>(count) * threads / syncSeconds;
+      double async = static_cast<double>(statistics.logged) / asyncSeconds;
+      char   row[128];
+      snprintf(row, sizeof(row),
+          "  %-10s %-8u %12.2f %10.2f %12.2f %10.2f %10llu\n", c.name,
+          threads, sync / 1e6, syncNanos, async / 1e6, asyncNanos,
+          static_cast<unsigned long long>(statistics.dropped));
+      rows.push_back(row);
+    }
+  }
+  std::cout.rdbuf(console);
+  file.close();
+  std::remove(path.c_str());
+  for (const std::string & row : rows)
+    std::cout << row;
+}
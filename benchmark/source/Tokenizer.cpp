@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Benchmark splitting delimited records into hashed fields, one
+ * character at a time versus the tokenizer
+ */
+void benchmarkTokenizer() {
+  const size_t size = 64 << 20;
+  std::string  buffer;
+  buffer.reserve(size + 64);
+  uint32_t state = 1;
+  while (buffer.size() < size) {
+    state         = state * 1103515245 + 12345;
+    size_t length = 2 + (state >> 16) % 14;
+    for (size_t i = 0; i < length; ++i)
+      buffer.push_back(static_cast<char>('a' + (state >> (i % 16)) % 26));
+    buffer.push_back((state >> 8) % 8 == 0 ? '\n' : ',');
+  }
+  const char * c      = buffer.c_str();
+  size_t       length = buffer.length();
+
+  std::cout << "tokenizer: 64 MB of 2-15 B fields separated by ',' and '\\n'\n";
+  reportThroughput("LiteHash add until delimiter per character",
+      measure(3, [&]() {
+        HashValue_t sum = 0;
+        LiteHash    hash;
+        for (size_t i = 0; i < length; ++i) {
+          if (c[i] == ',' || c[i] == '\n') {
+            sum += hash.get();
+            hash = LiteHash();
+          } else {
+            hash.add(c[i]);
+          }
+        }
+        doNotOptimize(sum);
+      }),
+      length);
+
+  Delimiters            delimiters(",\n", 2);
+  std::vector<uint32_t> offsets(4096);
+  reportThroughput("Delimiters find only", measure(3, [&]() {
+    size_t found = 0;
+    for (size_t i = 0; i < length; i += offsets.size()) {
+      size_t n = length - i < offsets.size() ? length - i : offsets.size();
+      found += delimiters.find(c + i, n, offsets.data());
+    }
+    doNotOptimize(found);
+  }), length);
+
+  Tokenizer tokenizer(",\n");
+  reportThroughput("Tokenizer (Jenkins)", measure(3, [&]() {
+    HashValue_t sum = 0;
+    tokenizer.tokenize(
+        c, length, [&](const Tokenizer::Token & token) { sum += token.hash; });
+    doNotOptimize(sum);
+  }), length);
+
+  TokenizerWy tokenizerWy(",\n");
+  reportThroughput("Tokenizer (WyHash)", measure(3, [&]() {
+    uint64_t sum = 0;
+    tokenizerWy.tokenize(c, length,
+        [&](const TokenizerWy::Token & token) { sum += token.hash; });
+    doNotOptimize(sum);
+  }), length);
+}
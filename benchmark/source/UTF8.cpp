@@ -0,0 +1,55 @@
+#include "Benchmark.h"
+
+#include <string>
+
+/**
+ * @brief Benchmark validating then hashing UTF-8 text in two passes versus
+ * validating and hashing in one
+ */
+void benchmarkUTF8() {
+  const size_t size    = 64 << 20;
+  const char * valid[] = {"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"};
+  std::string  buffer;
+  buffer.reserve(size + 4);
+  uint32_t state = 1;
+  while (buffer.size() < size) {
+    state = state * 1103515245 + 12345;
+    if ((state >> 16) % 8 == 0)
+      buffer += valid[(state >> 20) % 3];
+    else
+      buffer.push_back(static_cast<char>('a' + (state >> 20) % 26));
+  }
+  const char * c      = buffer.c_str();
+  size_t       length = buffer.length();
+
+  std::cout << "utf8: 64 MB of text, 1 in 8 characters multibyte\n";
+  reportThroughput("UTF8::validate", measure(3, [&]() {
+    doNotOptimize(UTF8::findInvalid(c, length));
+  }), length);
+
+  reportThroughput("UTF8::validate then WyHash::calculate", measure(3, [&]() {
+    uint64_t hash = 0;
+    if (UTF8::validate(c, length))
+      hash = WyHash::calculate(c, length);
+    doNotOptimize(hash);
+  }), length);
+
+  reportThroughput("UTF8::validateAndHash<WyHash>", measure(3, [&]() {
+    uint64_t hash = 0;
+    UTF8::validateAndHash<WyHash>(c, length, hash);
+    doNotOptimize(hash);
+  }), length);
+
+  reportThroughput("UTF8::validate then Jenkins::calculate", measure(3, [&]() {
+    HashValue_t hash = 0;
+    if (UTF8::validate(c, length))
+      hash = Jenkins::calculate(c, length);
+    doNotOptimize(hash);
+  }), length);
+
+  reportThroughput("UTF8::validateAndHash<Jenkins>", measure(3, [&]() {
+    HashValue_t hash = 0;
+    UTF8::validateAndHash(c, length, hash);
+    doNotOptimize(hash);
+  }), length);
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Named benchmark suite
+ */
+struct Suite {
+  const char * name;
+  void (*function)();
+};
+
+static const Suite SUITES[] = {
+    {"bloomFilter", benchmarkBloomFilter},
+    {"chunker", benchmarkChunker},
+    {"crc32c", benchmarkCRC32C},
+    {"errorStorm", benchmarkErrorStorm},
+    {"expected", benchmarkExpected},
+    {"file", benchmarkFile},
+    {"hash", benchmarkHash},
+    {"hashAlgorithms", benchmarkHashAlgorithms},
+    {"hashBatch", benchmarkHashBatch},
+    {"hashIndex", benchmarkHashIndex},
+    {"hashMap", benchmarkHashMap},
+    {"hashQuality", benchmarkHashQuality},
+    {"internTable", benchmarkInternTable},
+    {"move", benchmarkMove},
+    {"perfectHash", benchmarkPerfectHash},
+    {"referenceCount", benchmarkReferenceCount},
+    {"resultLog", benchmarkResultLog},
+    {"tokenizer", benchmarkTokenizer},
+    {"utf8", benchmarkUTF8},
+};
+
+/**
+ * @brief Run every benchmark suite, or only the suites named on the command
+ * line
+ *
+ * @param argc number of arguments
+ * @param argv suite names
+ * @return int 0 if every suite name was recognized
+ */
+int main(int argc, char * argv[]) {
+  std::cout << "Benchmarking FruitBowl\n";
+  int unknown = 0;
+  for (int i = 1; i < argc; ++i) {
+    bool found = false;
+    for (const Suite & suite : SUITES) {
+      if (strcmp(argv[i], suite.name) == 0) {
+        suite.function();
+        found = true;
+      }
+    }
+    if (!found) {
+      std::cout << "Unknown suite: " << argv[i] << "\n";
+      ++unknown;
+    }
+  }
+
+  if (argc <= 1) {
+    for (const Suite & suite : SUITES)
+      suite.function();
+  }
+
+  return unknown;
+}
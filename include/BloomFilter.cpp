@@ -0,0 +1,283 @@
+#include "BloomFilter.h"
+#include "CPU.h"
+#include "CRC32C.h"
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#ifdef FRUIT_BOWL_X86
+#include <immintrin.h>
+#endif /* FRUIT_BOWL_X86 */
+
+const char BloomFilter::MAGIC[8] = {'F', 'B', 'B', 'L', 'O', 'O', 'M', '\0'};
+
+/**
+ * @brief Construct a new Bloom Filter object
+ * The number of probes minimizes the false positive rate, bitsPerKey * ln(2)
+ *
+ * @param keys expected number of keys, more keys raise the false positive rate
+ * @param bitsPerKey number of bits of the filter per expected key
+ */
+BloomFilter::BloomFilter(size_t keys, size_t bitsPerKey) {
+  if (bitsPerKey < 1)
+    bitsPerKey = 1;
+  double ideal = std::round(static_cast<double>(bitsPerKey) * 0.6931);
+  probes       = ideal < 1 ? 1
+                     : (ideal > MAX_PROBES ? MAX_PROBES
+                                           : static_cast<uint32_t>(ideal));
+  const size_t blockBits = BLOCK_WORDS * 64;
+  allocate((keys * bitsPerKey + blockBits - 1) / blockBits);
+}
+
+/**
+ * @brief Allocate cleared blocks aligned to a cache line
+ *
+ * @param count number of blocks, at least 1 and at most 2^32
+ */
+void BloomFilter::allocate(size_t count) {
+  if (count < 1)
+    count = 1;
+  if (count > MAX_BLOCKS)
+    count = static_cast<size_t>(MAX_BLOCKS);
+  size_t words = count * BLOCK_WORDS + BLOCK_WORDS - 1;
+  storage.reset(new uint64_t[words]());
+  uintptr_t address = reinterpret_cast<uintptr_t>(storage.get());
+  uintptr_t aligned = (address + 63) & ~static_cast<uintptr_t>(63);
+  blocks     = storage.get() + (aligned - address) / sizeof(uint64_t);
+  blockCount = count;
+}
+
+/**
+ * @brief Add many hashed keys
+ * Blocks are prefetched a group ahead as each key is a cache miss in a large
+ * filter
+ *
+ * @param hashes of each key
+ * @param count number of keys
+ */
+void BloomFilter::add(const HashValue_t * hashes, size_t count) {
+  const size_t GROUP = 8;
+  Probe        group[GROUP];
+  for (size_t i = 0; i < count; i += GROUP) {
+    size_t n = count - i < GROUP ? count - i : GROUP;
+    for (size_t k = 0; k < n; ++k) {
+      group[k] = getProbe(hashes[i + k]);
+#ifdef FRUIT_BOWL_X86
+      _mm_prefetch(reinterpret_cast<const char *>(group[k].block), _MM_HINT_T0);
+#endif /* FRUIT_BOWL_X86 */
+    }
+    for (size_t k = 0; k < n; ++k) {
+      uint64_t h = group[k].h1;
+      for (uint32_t p = 0; p < probes; ++p) {
+        group[k].block[(group[k].start + p) & 7] |= static_cast<uint64_t>(1)
+                                                    << (h >> 58);
+        h += group[k].h2;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Test each probe's bits one at a time
+ *
+ * @param probes to test, BloomFilter::Probe
+ * @param count number of probes
+ * @param probeCount number of bits per key
+ * @param results output true if every bit is set
+ */
+template <class Probe>
+static void testScalar(const Probe * probes, size_t count, uint32_t probeCount,
+    bool * results) {
+  for (size_t k = 0; k < count; ++k) {
+    uint64_t h     = probes[k].h1;
+    uint64_t found = 1;
+    for (uint32_t p = 0; p < probeCount; ++p) {
+      found &= probes[k].block[(probes[k].start + p) & 7] >> (h >> 58);
+      h += probes[k].h2;
+    }
+    results[k] = (found & 1) != 0;
+  }
+}
+
+#ifdef FRUIT_BOWL_X86
+/**
+ * @brief Permutation of 32-bit lanes rotating 64-bit lanes up by 0 to 3
+ */
+alignas(32) static const int32_t ROTATE[4][8] = {{0, 1, 2, 3, 4, 5, 6, 7},
+    {6, 7, 0, 1, 2, 3, 4, 5}, {4, 5, 6, 7, 0, 1, 2, 3},
+    {2, 3, 4, 5, 6, 7, 0, 1}};
+
+/**
+ * @brief 64-bit lanes below a rotation of 0 to 3, which wrap from the other
+ * half of a block
+ */
+alignas(32) static const int64_t WRAPPED[4][4] = {
+    {0, 0, 0, 0}, {-1, 0, 0, 0}, {-1, -1, 0, 0}, {-1, -1, -1, 0}};
+
+/**
+ * @brief Test each probe's bits at once, building the mask of a block four
+ * probes at a time
+ * Probes 0-3 and 8-11 build words 0-3, probes 4-7 and 12-15 words 4-7, lanes
+ * past probeCount are masked off. The mask is then rotated up by start words.
+ *
+ * @param probes to test, BloomFilter::Probe
+ * @param count number of probes
+ * @param probeCount number of bits per key
+ * @param results output true if every bit is set
+ */
+template <class Probe>
+FB_TARGET("avx2")
+static void testAVX2(const Probe * probes, size_t count, uint32_t probeCount,
+    bool * results) {
+  const __m256i lanes = _mm256_set_epi64x(3, 2, 1, 0);
+  const __m256i one   = _mm256_set1_epi64x(1);
+  __m256i       active[4];
+  for (int r = 0; r < 4; ++r)
+    active[r] = _mm256_cmpgt_epi64(
+        _mm256_set1_epi64x(static_cast<int64_t>(probeCount) - r * 4), lanes);
+
+  for (size_t k = 0; k < count; ++k) {
+    uint64_t h2 = probes[k].h2;
+    __m256i  h  = _mm256_add_epi64(_mm256_set1_epi64x(probes[k].h1),
+        _mm256_set_epi64x(3 * h2, 2 * h2, h2, 0));
+    __m256i  step = _mm256_set1_epi64x(4 * h2);
+    __m256i  mask[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+    for (int r = 0; r < 4; ++r) {
+      __m256i bits = _mm256_sllv_epi64(one, _mm256_srli_epi64(h, 58));
+      mask[r & 1]  = _mm256_or_si256(mask[r & 1],
+          _mm256_and_si256(bits, active[r]));
+      h            = _mm256_add_epi64(h, step);
+    }
+    uint32_t start = probes[k].start;
+    if (start >= 4)
+      std::swap(mask[0], mask[1]);
+    start &= 3;
+    __m256i rotate = _mm256_load_si256(
+        reinterpret_cast<const __m256i *>(ROTATE[start]));
+    __m256i wrapped = _mm256_load_si256(
+        reinterpret_cast<const __m256i *>(WRAPPED[start]));
+    __m256i low  = _mm256_permutevar8x32_epi32(mask[0], rotate);
+    __m256i high = _mm256_permutevar8x32_epi32(mask[1], rotate);
+    // Select with and/andnot, GCC miscompiles blendv with -funsigned-char
+    mask[0] = _mm256_or_si256(_mm256_and_si256(wrapped, high),
+        _mm256_andnot_si256(wrapped, low));
+    mask[1] = _mm256_or_si256(_mm256_and_si256(wrapped, low),
+        _mm256_andnot_si256(wrapped, high));
+
+    const __m256i * block =
+        reinterpret_cast<const __m256i *>(probes[k].block);
+    results[k] = (_mm256_testc_si256(_mm256_load_si256(block), mask[0]) &
+                     _mm256_testc_si256(_mm256_load_si256(block + 1),
+                         mask[1])) != 0;
+  }
+}
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Test many hashed keys
+ * Blocks are prefetched a group ahead as each key is a cache miss in a large
+ * filter, then tested with the widest instructions available
+ *
+ * @param hashes of each key
+ * @param count number of keys
+ * @param results output true if the key may have been added
+ * @return size_t number of keys that may have been added
+ */
+size_t BloomFilter::contains(
+    const HashValue_t * hashes, size_t count, bool * results) const {
+  typedef void (*Test_t)(const Probe *, size_t, uint32_t, bool *);
+  static const Test_t test = []() -> Test_t {
+#ifdef FRUIT_BOWL_X86
+    if (CPU::getFeatures().avx2)
+      return testAVX2<Probe>;
+#endif /* FRUIT_BOWL_X86 */
+    return testScalar<Probe>;
+  }();
+
+  const size_t GROUP = 16;
+  Probe        group[GROUP];
+  size_t       found = 0;
+  for (size_t i = 0; i < count; i += GROUP) {
+    size_t n = count - i < GROUP ? count - i : GROUP;
+    for (size_t k = 0; k < n; ++k) {
+      group[k] = getProbe(hashes[i + k]);
+#ifdef FRUIT_BOWL_X86
+      _mm_prefetch(reinterpret_cast<const char *>(group[k].block), _MM_HINT_T0);
+#endif /* FRUIT_BOWL_X86 */
+    }
+    if (probes == 0) {
+      for (size_t k = 0; k < n; ++k)
+        results[i + k] = true;
+    } else {
+      test(group, n, probes, results + i);
+    }
+    for (size_t k = 0; k < n; ++k)
+      found += results[i + k];
+  }
+  return found;
+}
+
+/**
+ * @brief Remove every key, keeping the size
+ */
+void BloomFilter::clear() {
+  if (blocks != nullptr)
+    memset(blocks, 0, blockCount * BLOCK_WORDS * sizeof(uint64_t));
+}
+
+/**
+ * @brief Serialize the filter, to be stored next to the keys it filters
+ * A header with a CRC32C checksum followed by the blocks, little endian
+ *
+ * @param image output contents
+ */
+void BloomFilter::save(std::string & image) const {
+  size_t bytes = blockCount * BLOCK_WORDS * sizeof(uint64_t);
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MAGIC, sizeof(header.magic));
+  header.version    = VERSION;
+  header.probes     = probes;
+  header.blockCount = blockCount;
+  header.crc = CRC32C::calculate(reinterpret_cast<const char *>(blocks), bytes);
+  image.assign(reinterpret_cast<const char *>(&header), sizeof(header));
+  image.append(reinterpret_cast<const char *>(blocks), bytes);
+}
+
+/**
+ * @brief Deserialize a filter saved by save, replacing this filter
+ * The blocks are copied so data may be unaligned and released afterwards
+ *
+ * @param data of the saved filter
+ * @param size number of characters
+ * @return Result INVALID_DATA if not a filter of this version or of more than
+ * 2^32 blocks, CRC if the checksum does not match, this filter is unchanged
+ * on failure
+ */
+Result BloomFilter::load(const char * data, size_t size) {
+  Header header;
+  if (size < sizeof(Header))
+    return ResultCode_t::INVALID_DATA + "Filter is smaller than its header";
+  memcpy(&header, data, sizeof(Header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    return ResultCode_t::INVALID_DATA + "Filter does not start with FBBLOOM";
+  if (header.version != VERSION)
+    return ResultCode_t::INVALID_DATA +
+           ("Filter version " + std::to_string(header.version) +
+               " is not supported");
+  const size_t blockBytes = BLOCK_WORDS * sizeof(uint64_t);
+  if (header.probes < 1 || header.probes > MAX_PROBES ||
+      header.blockCount < 1 || header.blockCount > MAX_BLOCKS ||
+      header.blockCount != (size - sizeof(Header)) / blockBytes ||
+      (size - sizeof(Header)) % blockBytes != 0)
+    return ResultCode_t::INVALID_DATA + "Filter header is not consistent";
+  const char * body = data + sizeof(Header);
+  if (CRC32C::calculate(body, size - sizeof(Header)) != header.crc)
+    return ResultCode_t::CRC + "Filter checksum does not match";
+
+  allocate(static_cast<size_t>(header.blockCount));
+  probes = header.probes;
+  memcpy(blocks, body, size - sizeof(Header));
+  return ResultCode_t::SUCCESS;
+}
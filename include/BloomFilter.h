@@ -0,0 +1,256 @@
+#ifndef _FB_BLOOM_FILTER_H_
+#define _FB_BLOOM_FILTER_H_
+
+#include "Hash.h"
+#include "Result.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+
+/**
+ * @brief Set membership test with false positives but no false negatives, to
+ * reject unknown keys before probing a table
+ * Blocked Bloom filter: each key selects one 64 byte block (a cache line) and
+ * sets getProbes() bits in it, probe i sets a bit of word (start + i) % 8 so
+ * every word fills evenly. The block, start and bit positions are derived
+ * from the 32-bit hash (same as Hash) by double hashing, so keys are never
+ * rehashed. About 10 bits per key gives 1% false
+ * positives.
+ *
+ */
+class BloomFilter {
+public:
+  /**
+   * @brief Format version written by save and accepted by load
+   */
+  static const uint32_t VERSION = 1;
+
+  /**
+   * @brief Largest number of bits set per key
+   */
+  static const uint32_t MAX_PROBES = 16;
+
+  BloomFilter(size_t keys = 0, size_t bitsPerKey = 10);
+
+  /**
+   * @brief Move constructor
+   * Take the blocks from the other filter, leaving it without blocks, where
+   * every key may have been added
+   *
+   * @param filter to move
+   */
+  BloomFilter(BloomFilter && filter) noexcept :
+    storage(std::move(filter.storage)), blocks(filter.blocks),
+    blockCount(filter.blockCount), probes(filter.probes) {
+    filter.blocks     = nullptr;
+    filter.blockCount = 0;
+    filter.probes     = 0;
+  }
+
+  /**
+   * @brief Move assignment operator
+   * Swap the blocks with the other filter, which releases them when destroyed
+   *
+   * @param filter to move
+   * @return BloomFilter&
+   */
+  BloomFilter & operator=(BloomFilter && filter) noexcept {
+    std::swap(storage, filter.storage);
+    std::swap(blocks, filter.blocks);
+    std::swap(blockCount, filter.blockCount);
+    std::swap(probes, filter.probes);
+    return *this;
+  }
+
+  BloomFilter(const BloomFilter & filter) = delete;
+  BloomFilter & operator=(const BloomFilter & filter) = delete;
+
+  /**
+   * @brief Add a hashed key
+   *
+   * @param hash of the key
+   */
+  inline void add(HashValue_t hash) {
+    Probe    probe = getProbe(hash);
+    uint64_t h     = probe.h1;
+    for (uint32_t i = 0; i < probes; ++i) {
+      probe.block[(probe.start + i) & 7] |= static_cast<uint64_t>(1)
+                                             << (h >> 58);
+      h += probe.h2;
+    }
+  }
+
+  /**
+   * @brief Add a key
+   *
+   * @param key to add
+   */
+  inline void add(const Hash & key) {
+    add(key.get());
+  }
+
+  /**
+   * @brief Add a key
+   *
+   * @param key to add
+   * @param length number of characters
+   */
+  inline void add(const char * key, size_t length) {
+    add(Jenkins::calculate(key, length));
+  }
+
+  /**
+   * @brief Add a key
+   *
+   * @param key to add
+   */
+  inline void add(const std::string & key) {
+    add(key.c_str(), key.length());
+  }
+
+  void add(const HashValue_t * hashes, size_t count);
+
+  /**
+   * @brief Test if a hashed key may have been added
+   *
+   * @param hash of the key
+   * @return true if the key may have been added
+   * @return false if the key was not added
+   */
+  inline bool contains(HashValue_t hash) const {
+    Probe    probe = getProbe(hash);
+    uint64_t h     = probe.h1;
+    for (uint32_t i = 0; i < probes; ++i) {
+      if (((probe.block[(probe.start + i) & 7] >> (h >> 58)) & 1) == 0)
+        return false;
+      h += probe.h2;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Test if a key may have been added
+   *
+   * @param key to test
+   * @return true if the key may have been added
+   * @return false if the key was not added
+   */
+  inline bool contains(const Hash & key) const {
+    return contains(key.get());
+  }
+
+  /**
+   * @brief Test if a key may have been added
+   *
+   * @param key to test
+   * @param length number of characters
+   * @return true if the key may have been added
+   * @return false if the key was not added
+   */
+  inline bool contains(const char * key, size_t length) const {
+    return contains(Jenkins::calculate(key, length));
+  }
+
+  /**
+   * @brief Test if a key may have been added
+   *
+   * @param key to test
+   * @return true if the key may have been added
+   * @return false if the key was not added
+   */
+  inline bool contains(const std::string & key) const {
+    return contains(key.c_str(), key.length());
+  }
+
+  size_t contains(
+      const HashValue_t * hashes, size_t count, bool * results) const;
+
+  void   clear();
+  void   save(std::string & image) const;
+  Result load(const char * data, size_t size);
+
+  /**
+   * @brief Get the number of bits set per key
+   *
+   * @return uint32_t probes
+   */
+  inline uint32_t getProbes() const {
+    return probes;
+  }
+
+  /**
+   * @brief Get the number of bits of the filter
+   *
+   * @return size_t bits, a multiple of 512
+   */
+  inline size_t getBits() const {
+    return blockCount * BLOCK_WORDS * 64;
+  }
+
+  /**
+   * @brief Get the number of bytes used by the filter and its blocks
+   *
+   * @return size_t bytes
+   */
+  inline size_t getMemoryUsage() const {
+    return sizeof(BloomFilter) +
+           (blockCount == 0 ? 0 : (blockCount + 1) * BLOCK_WORDS * 8 - 8);
+  }
+
+private:
+  static const size_t   BLOCK_WORDS = 8;
+  static const uint64_t MAX_BLOCKS  = static_cast<uint64_t>(1) << 32;
+
+  /**
+   * @brief Start of a saved filter
+   */
+  struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t probes;
+    uint64_t blockCount;
+    uint32_t crc;
+    uint32_t reserved;
+  };
+
+  /**
+   * @brief Block and double hashing state of a key
+   */
+  struct Probe {
+    uint64_t * block;
+    uint64_t   h1;
+    uint64_t   h2;
+    uint32_t   start;
+  };
+
+  static const char MAGIC[8];
+
+  /**
+   * @brief Derive the block and probe sequence of a hash
+   * The block is chosen by the high half of a Fibonacci multiply (as
+   * HashMap), the probes from a second multiply so they are independent of
+   * the block. h2 is odd so it is never 0.
+   *
+   * @param hash of the key
+   * @return Probe
+   */
+  inline Probe getProbe(HashValue_t hash) const {
+    uint64_t a     = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    uint64_t index = ((a >> 32) * blockCount) >> 32;
+    uint64_t b     = (a ^ (a >> 29)) * 0xBF58476D1CE4E5B9ull;
+    b ^= b >> 32;
+    return Probe{blocks + index * BLOCK_WORDS, b, ((b << 32) | (b >> 32)) | 1,
+        static_cast<uint32_t>(b >> 29) & 7};
+  }
+
+  void allocate(size_t count);
+
+  std::unique_ptr<uint64_t[]> storage;
+  uint64_t *                  blocks     = nullptr;
+  size_t                      blockCount = 0;
+  uint32_t                    probes     = 1;
+};
+
+#endif /* _FB_BLOOM_FILTER_H_ */
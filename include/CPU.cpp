@@ -0,0 +1,98 @@
+#include "CPU.h"
+
+#ifdef FRUIT_BOWL_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif /* FRUIT_BOWL_X86 */
+
+namespace CPU {
+
+#ifdef FRUIT_BOWL_X86
+/**
+ * @brief Query the processor's identification and features
+ *
+ * @param leaf to query
+ * @param subleaf to query
+ * @param registers output eax, ebx, ecx, edx
+ */
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4]) {
+#ifdef _MSC_VER
+  int values[4];
+  __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i)
+    registers[i] = static_cast<uint32_t>(values[i]);
+#else
+  __cpuid_count(
+      leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+/**
+ * @brief Read the extended control register of register states the
+ * operating system saves on a context switch
+ *
+ * @return uint64_t XCR0
+ */
+static uint64_t xgetbv() {
+#ifdef _MSC_VER
+  return _xgetbv(0);
+#else
+  uint32_t eax;
+  uint32_t edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Detect the supported features
+ *
+ * @return Features
+ */
+static Features detect() {
+  Features features;
+#ifdef FRUIT_BOWL_X86
+  uint32_t registers[4];
+  cpuid(0, 0, registers);
+  uint32_t maxLeaf = registers[0];
+  if (maxLeaf < 1)
+    return features;
+
+  cpuid(1, 0, registers);
+  features.sse2   = (registers[3] & (1u << 26)) != 0;
+  features.ssse3  = (registers[2] & (1u << 9)) != 0;
+  features.sse41  = (registers[2] & (1u << 19)) != 0;
+  features.sse42  = (registers[2] & (1u << 20)) != 0;
+  features.pclmul = (registers[2] & (1u << 1)) != 0;
+
+  // AVX registers are only usable if the OS saves them (OSXSAVE and XCR0)
+  bool     osxsave = (registers[2] & (1u << 27)) != 0;
+  uint64_t xcr0    = osxsave ? xgetbv() : 0;
+  bool     avx     = (registers[2] & (1u << 28)) != 0 && (xcr0 & 0x06) == 0x06;
+  bool     avx512  = avx && (xcr0 & 0xE0) == 0xE0;
+  if (maxLeaf < 7)
+    return features;
+
+  cpuid(7, 0, registers);
+  features.avx2     = avx && (registers[1] & (1u << 5)) != 0;
+  features.avx512f  = avx512 && (registers[1] & (1u << 16)) != 0;
+  features.avx512bw = features.avx512f && (registers[1] & (1u << 30)) != 0;
+#endif /* FRUIT_BOWL_X86 */
+  return features;
+}
+
+/**
+ * @brief Get the supported features, detected once on first use
+ *
+ * @return const Features &
+ */
+const Features & getFeatures() {
+  static const Features features = detect();
+  return features;
+}
+
+} // namespace CPU
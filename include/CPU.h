@@ -0,0 +1,47 @@
+#ifndef _FB_CPU_H_
+#define _FB_CPU_H_
+
+#include <stdint.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) ||             \
+    defined(__i386__)
+#define FRUIT_BOWL_X86
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FRUIT_BOWL_X64
+#endif
+
+/**
+ * @brief Compile a function for an instruction set extension, selected at
+ * runtime with CPU::getFeatures
+ * MSVC allows any intrinsic without an attribute
+ */
+#if defined(FRUIT_BOWL_X86) && !defined(_MSC_VER)
+#define FB_TARGET(features) __attribute__((target(features)))
+#else
+#define FB_TARGET(features)
+#endif
+
+namespace CPU {
+
+/**
+ * @brief Instruction set extensions supported by the processor and enabled by
+ * the operating system
+ */
+struct Features {
+  bool sse2     = false;
+  bool ssse3    = false;
+  bool sse41    = false;
+  bool sse42    = false;
+  bool pclmul   = false;
+  bool avx2     = false;
+  bool avx512f  = false;
+  bool avx512bw = false;
+};
+
+const Features & getFeatures();
+
+} // namespace CPU
+
+#endif /* _FB_CPU_H_ */
@@ -0,0 +1,305 @@
+#include "CPU.h"
+#include "CRC32C.h"
+
+#include <cstring>
+#include <stdio.h>
+
+#ifdef FRUIT_BOWL_X86
+#include <immintrin.h>
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Castagnoli polynomial, bit reversed
+ */
+static const uint32_t POLYNOMIAL = 0x82F63B78;
+
+/**
+ * @brief Number of characters of each of the three streams checksummed in
+ * parallel, long streams first then short
+ */
+static const size_t STREAM_LONG  = 8192;
+static const size_t STREAM_SHORT = 256;
+
+/**
+ * @brief Multiply two polynomials modulo the CRC polynomial
+ * Bit 31 is the coefficient of x^0 (bit reversed like the checksum)
+ *
+ * @param a polynomial
+ * @param b polynomial
+ * @return uint32_t product
+ */
+static uint32_t multiply(uint32_t a, uint32_t b) {
+  uint32_t product = 0;
+  for (uint32_t bit = 1u << 31; bit != 0; bit >>= 1) {
+    if (a & bit)
+      product ^= b;
+    b = (b & 1) ? (b >> 1) ^ POLYNOMIAL : b >> 1;
+  }
+  return product;
+}
+
+/**
+ * @brief Lookup tables, built once on first use
+ */
+struct Tables {
+  /**
+   * @brief slices[k][i] is the checksum of byte i followed by k zeros
+   */
+  uint32_t slices[8][256];
+
+  /**
+   * @brief powers[k] is x^(2^k) modulo the polynomial
+   */
+  uint32_t powers[64];
+
+  /**
+   * @brief Multipliers advancing a checksum past one long or short stream,
+   * x^(8 * length - 33) since the product of PCLMULQDQ and the crc32
+   * instruction multiply by a further x^33
+   */
+  uint32_t shiftLong;
+  uint32_t shiftShort;
+
+  Tables();
+
+  /**
+   * @brief Calculate x^n modulo the polynomial
+   *
+   * @param n exponent
+   * @return uint32_t power
+   */
+  uint32_t power(uint64_t n) const {
+    uint32_t result = 1u << 31;
+    for (size_t k = 0; n != 0; n >>= 1, ++k) {
+      if (n & 1)
+        result = multiply(result, powers[k]);
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Construct the tables
+ */
+Tables::Tables() {
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ POLYNOMIAL : crc >> 1;
+    slices[0][i] = crc;
+  }
+  for (size_t k = 1; k < 8; ++k) {
+    for (size_t i = 0; i < 256; ++i) {
+      uint32_t crc = slices[k - 1][i];
+      slices[k][i] = (crc >> 8) ^ slices[0][crc & 0xFF];
+    }
+  }
+
+  powers[0] = 1u << 30;
+  for (size_t k = 1; k < 64; ++k)
+    powers[k] = multiply(powers[k - 1], powers[k - 1]);
+
+  shiftLong  = power(8 * STREAM_LONG - 33);
+  shiftShort = power(8 * STREAM_SHORT - 33);
+}
+
+/**
+ * @brief Get the tables
+ *
+ * @return const Tables &
+ */
+static const Tables & getTables() {
+  static const Tables tables;
+  return tables;
+}
+
+#ifdef FRUIT_BOWL_X64
+/**
+ * @brief Update a running (inverted) checksum 8 characters at a time with
+ * the crc32 instruction
+ *
+ * @param state running checksum
+ * @param c array to add
+ * @param length number of characters
+ * @return uint64_t running checksum
+ */
+FB_TARGET("sse4.2")
+static inline uint64_t updateSSE42(
+    uint64_t state, const char * c, size_t length) {
+  for (; length >= 8; length -= 8, c += 8) {
+    uint64_t word;
+    memcpy(&word, c, 8);
+    state = _mm_crc32_u64(state, word);
+  }
+  for (; length > 0; --length, ++c)
+    state = _mm_crc32_u8(static_cast<uint32_t>(state),
+        static_cast<uint8_t>(*c));
+  return state;
+}
+
+/**
+ * @brief Calculate the checksum with the crc32 instruction
+ *
+ * @param c array to add
+ * @param length number of characters
+ * @param crc checksum of the characters before
+ * @return uint32_t checksum
+ */
+FB_TARGET("sse4.2")
+static uint32_t calculateSSE42(const char * c, size_t length, uint32_t crc) {
+  return ~static_cast<uint32_t>(updateSSE42(~crc, c, length));
+}
+
+/**
+ * @brief Advance a running checksum past a stream of zeros
+ * Multiplies by x^(8 * length) in one carry-less multiply and one crc32
+ *
+ * @param state running checksum
+ * @param shift x^(8 * length - 33) of the stream
+ * @return uint64_t running checksum
+ */
+FB_TARGET("sse4.2,pclmul")
+static inline uint64_t shiftCLMUL(uint64_t state, uint32_t shift) {
+  __m128i product = _mm_clmulepi64_si128(
+      _mm_cvtsi32_si128(static_cast<int>(state)),
+      _mm_cvtsi32_si128(static_cast<int>(shift)), 0x00);
+  return _mm_crc32_u64(0, static_cast<uint64_t>(_mm_cvtsi128_si64(product)));
+}
+
+/**
+ * @brief Calculate the checksum with three independent crc32 streams
+ * The crc32 instruction has a latency of 3 cycles but a throughput of 1, so
+ * three consecutive streams are checksummed together and merged by shifting
+ * the first two past the streams after them
+ *
+ * @param c array to add
+ * @param length number of characters
+ * @param crc checksum of the characters before
+ * @return uint32_t checksum
+ */
+FB_TARGET("sse4.2,pclmul")
+static uint32_t calculateCLMUL(const char * c, size_t length, uint32_t crc) {
+  uint64_t state = static_cast<uint32_t>(~crc);
+  if (length < 3 * STREAM_SHORT)
+    return ~static_cast<uint32_t>(updateSSE42(state, c, length));
+
+  const Tables & tables     = getTables();
+  const size_t   streams[2] = {STREAM_LONG, STREAM_SHORT};
+  const uint32_t shifts[2]  = {tables.shiftLong, tables.shiftShort};
+  for (size_t s = 0; s < 2; ++s) {
+    const size_t stream = streams[s];
+    for (; length >= 3 * stream; length -= 3 * stream, c += 3 * stream) {
+      uint64_t crc0 = state;
+      uint64_t crc1 = 0;
+      uint64_t crc2 = 0;
+      for (size_t i = 0; i < stream; i += 8) {
+        uint64_t words[3];
+        memcpy(&words[0], c + i, 8);
+        memcpy(&words[1], c + stream + i, 8);
+        memcpy(&words[2], c + 2 * stream + i, 8);
+        crc0 = _mm_crc32_u64(crc0, words[0]);
+        crc1 = _mm_crc32_u64(crc1, words[1]);
+        crc2 = _mm_crc32_u64(crc2, words[2]);
+      }
+      state = shiftCLMUL(crc0, shifts[s]) ^ crc1;
+      state = shiftCLMUL(state, shifts[s]) ^ crc2;
+    }
+  }
+  return ~static_cast<uint32_t>(updateSSE42(state, c, length));
+}
+#endif /* FRUIT_BOWL_X64 */
+
+/**
+ * @brief Function calculating the checksum of a character array
+ */
+typedef uint32_t (*Calculate_t)(const char * c, size_t length, uint32_t crc);
+
+/**
+ * @brief Select the fastest calculation the processor supports
+ *
+ * @return Calculate_t function
+ */
+static Calculate_t select() {
+#ifdef FRUIT_BOWL_X64
+  const CPU::Features & cpu = CPU::getFeatures();
+  if (cpu.sse42 && cpu.pclmul)
+    return calculateCLMUL;
+  if (cpu.sse42)
+    return calculateSSE42;
+#endif /* FRUIT_BOWL_X64 */
+  return CRC32C::calculateSoftware;
+}
+
+/**
+ * @brief Check the checksum matches an expected value
+ *
+ * @param expected checksum
+ * @return Result CRC if the checksums do not match
+ */
+Result CRC32C::check(uint32_t expected) const {
+  if (crc == expected)
+    return ResultCode_t::SUCCESS;
+  char message[64];
+  snprintf(message, sizeof(message),
+      "CRC32C 0x%08X does not match expected 0x%08X", crc, expected);
+  return ResultCode_t::CRC + message;
+}
+
+/**
+ * @brief Calculate the checksum of a character array
+ *
+ * @param c array to add
+ * @param length number of characters
+ * @param crc checksum of the characters before, 0 if none
+ * @return uint32_t checksum
+ */
+uint32_t CRC32C::calculate(const char * c, size_t length, uint32_t crc) {
+  static const Calculate_t function = select();
+  return function(c, length, crc);
+}
+
+/**
+ * @brief Calculate the checksum of a character array eight characters at a
+ * time with lookup tables, the fallback without the crc32 instruction
+ *
+ * @param c array to add
+ * @param length number of characters
+ * @param crc checksum of the characters before, 0 if none
+ * @return uint32_t checksum
+ */
+uint32_t CRC32C::calculateSoftware(
+    const char * c, size_t length, uint32_t crc) {
+  const Tables &  tables = getTables();
+  const uint8_t * p      = reinterpret_cast<const uint8_t *>(c);
+  uint32_t        state  = ~crc;
+  for (; length >= 8; length -= 8, p += 8) {
+    uint32_t low;
+    uint32_t high;
+    memcpy(&low, p, 4);
+    memcpy(&high, p + 4, 4);
+    low ^= state;
+    state = tables.slices[7][low & 0xFF] ^
+            tables.slices[6][(low >> 8) & 0xFF] ^
+            tables.slices[5][(low >> 16) & 0xFF] ^
+            tables.slices[4][low >> 24] ^ tables.slices[3][high & 0xFF] ^
+            tables.slices[2][(high >> 8) & 0xFF] ^
+            tables.slices[1][(high >> 16) & 0xFF] ^
+            tables.slices[0][high >> 24];
+  }
+  for (; length > 0; --length, ++p)
+    state = (state >> 8) ^ tables.slices[0][(state ^ *p) & 0xFF];
+  return ~state;
+}
+
+/**
+ * @brief Combine the checksums of two consecutive character arrays
+ *
+ * @param crcA checksum of the first array
+ * @param crcB checksum of the second array
+ * @param lengthB number of characters of the second array
+ * @return uint32_t checksum of the first array followed by the second
+ */
+uint32_t CRC32C::combine(uint32_t crcA, uint32_t crcB, size_t lengthB) {
+  return multiply(getTables().power(8 * static_cast<uint64_t>(lengthB)), crcA) ^
+         crcB;
+}
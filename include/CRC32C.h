@@ -0,0 +1,74 @@
+#ifndef _FB_CRC32C_H_
+#define _FB_CRC32C_H_
+
+#include "Result.h"
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief CRC-32C (Castagnoli) checksum, as used by iSCSI, ext4 and SCTP
+ * Uses the SSE4.2 crc32 instruction as supported by the processor, running
+ * three streams in parallel merged with PCLMULQDQ on large arrays, else
+ * slicing-by-8 tables. Checksums of separate chunks merge with combine, so a
+ * large array can be checksummed by several threads.
+ *
+ */
+class CRC32C {
+public:
+  /**
+   * @brief Construct a new CRC32C object
+   *
+   * @param crc checksum of the characters before those to add
+   */
+  CRC32C(uint32_t crc = 0) : crc(crc) {}
+
+  /**
+   * @brief Add a character to the checksum
+   *
+   * @param c to add
+   */
+  inline void add(const char c) {
+    crc = calculate(&c, 1, crc);
+  }
+
+  /**
+   * @brief Add a character array, length characters long
+   *
+   * @param c array to add
+   * @param length number of characters
+   */
+  inline void add(const char * c, size_t length) {
+    crc = calculate(c, length, crc);
+  }
+
+  /**
+   * @brief Add a string to the checksum
+   *
+   * @param str to add
+   */
+  inline void add(const std::string & str) {
+    add(str.c_str(), str.length());
+  }
+
+  /**
+   * @brief Get the current checksum
+   *
+   * @return uint32_t checksum
+   */
+  inline uint32_t get() const {
+    return crc;
+  }
+
+  Result check(uint32_t expected) const;
+
+  static uint32_t calculate(const char * c, size_t length, uint32_t crc = 0);
+  static uint32_t calculateSoftware(
+      const char * c, size_t length, uint32_t crc = 0);
+  static uint32_t combine(uint32_t crcA, uint32_t crcB, size_t lengthB);
+
+private:
+  uint32_t crc;
+};
+
+#endif /* _FB_CRC32C_H_ */
@@ -0,0 +1,113 @@
+#include "Chunker.h"
+
+/**
+ * @brief Number of mask bits added before the average size and removed after
+ * it (FastCDC normalization level)
+ */
+static const int NORMALIZATION = 2;
+
+/**
+ * @brief Random value of each character for the Gear hash, from splitmix64
+ */
+struct GearTable {
+  uint64_t values[256];
+
+  /**
+   * @brief Construct the table at compile time
+   */
+  constexpr GearTable() : values() {
+    uint64_t state = 0x46727569742B4364; // "Fruit+Cd"
+    for (size_t i = 0; i < 256; ++i) {
+      state += 0x9E3779B97F4A7C15;
+      uint64_t z = state;
+      z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+      z          = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+      values[i]  = z ^ (z >> 31);
+    }
+  }
+};
+
+static constexpr GearTable GEAR;
+
+/**
+ * @brief Create a mask of the highest bits of the hash, which depend on the
+ * most characters
+ *
+ * @param bits number of bits set
+ * @return uint64_t mask
+ */
+static uint64_t highBits(int bits) {
+  bits = bits < 1 ? 1 : (bits > 63 ? 63 : bits);
+  return ~static_cast<uint64_t>(0) << (64 - bits);
+}
+
+/**
+ * @brief Construct a new Chunk Boundaries object
+ *
+ * @param minimum size of a chunk, no boundary is tested before it
+ * @param average size of a chunk, rounded down to a power of 2
+ * @param maximum size of a chunk, always a boundary
+ */
+ChunkBoundaries::ChunkBoundaries(
+    size_t minimum, size_t average, size_t maximum) :
+  minimum(minimum), average(average), maximum(maximum) {
+  if (this->maximum < 1)
+    this->maximum = 1;
+  if (this->minimum > this->maximum)
+    this->minimum = this->maximum;
+  int bits = 0;
+  while (bits < 63 && (static_cast<uint64_t>(2) << bits) <= average)
+    ++bits;
+  maskSmall     = highBits(bits + NORMALIZATION);
+  maskLarge     = highBits(bits - NORMALIZATION);
+  this->average = static_cast<size_t>(1) << bits;
+  if (this->average > this->maximum)
+    this->average = this->maximum;
+}
+
+/**
+ * @brief Find the end of the current chunk in the next characters
+ *
+ * @param c array to search
+ * @param length number of characters
+ * @param consumed output number of characters of the current chunk
+ * @return true if the current chunk ended after consumed characters, the next
+ * search starts a new chunk
+ * @return false if every character is part of the current chunk
+ */
+bool ChunkBoundaries::find(const char * c, size_t length, size_t & consumed) {
+  const uint8_t * p = reinterpret_cast<const uint8_t *>(c);
+  size_t          i = 0;
+  if (size < minimum) {
+    i = minimum - size < length ? minimum - size : length;
+    size += i;
+  }
+  while (i < length) {
+    uint64_t mask  = maskLarge;
+    size_t   limit = maximum;
+    if (size < average) {
+      mask  = maskSmall;
+      limit = average;
+    }
+    size_t   start = i;
+    size_t   end   = limit - size < length - i ? i + limit - size : length;
+    uint64_t value = hash;
+    for (; i < end; ++i) {
+      value = (value << 1) + GEAR.values[p[i]];
+      if ((value & mask) == 0) {
+        consumed = i + 1;
+        reset();
+        return true;
+      }
+    }
+    hash = value;
+    size += i - start;
+    if (size >= maximum) {
+      consumed = i;
+      reset();
+      return true;
+    }
+  }
+  consumed = length;
+  return false;
+}
@@ -0,0 +1,176 @@
+#ifndef _FB_CHUNKER_H_
+#define _FB_CHUNKER_H_
+
+#include "HashAlgorithm.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Content defined chunk boundaries of a stream (FastCDC)
+ * A Gear rolling hash over roughly the last 64 characters is tested against a
+ * mask after each character, so boundaries move with the content rather than
+ * its offset. Until the average size a mask with more bits is used, after it
+ * one with fewer, narrowing the distribution of sizes around the average.
+ *
+ */
+class ChunkBoundaries {
+public:
+  ChunkBoundaries(size_t minimum, size_t average, size_t maximum);
+
+  bool find(const char * c, size_t length, size_t & consumed);
+
+  /**
+   * @brief Start a new chunk
+   */
+  inline void reset() {
+    hash = 0;
+    size = 0;
+  }
+
+private:
+  size_t   minimum;
+  size_t   average;
+  size_t   maximum;
+  uint64_t maskSmall;
+  uint64_t maskLarge;
+  uint64_t hash = 0;
+  size_t   size = 0;
+};
+
+/**
+ * @brief Splits a stream into content defined chunks, hashing each chunk
+ * Input is added incrementally in arrays of any size, nothing is kept apart
+ * from the running hashes so a chunk may span arrays. Inserting or removing
+ * characters only changes the chunks around the edit, so similar streams
+ * share most chunk hashes. Hashes match BasicHash of the same algorithm.
+ *
+ * @tparam Algorithm to calculate the hashes with
+ */
+template <class Algorithm>
+class BasicChunker {
+public:
+  typedef typename Algorithm::Value_t Value_t;
+
+  /**
+   * @brief Contiguous characters of the stream and their hash
+   */
+  struct Chunk {
+    uint64_t offset;
+    size_t   length;
+    Value_t  hash;
+  };
+
+  /**
+   * @brief Default chunk sizes, 2 KB to 64 KB averaging 8 KB
+   */
+  static const size_t MINIMUM = 2 << 10;
+  static const size_t AVERAGE = 8 << 10;
+  static const size_t MAXIMUM = 64 << 10;
+
+  /**
+   * @brief Construct a new Chunker object
+   *
+   * @param minimum size of a chunk, apart from the last
+   * @param average size of a chunk, rounded down to a power of 2
+   * @param maximum size of a chunk
+   */
+  BasicChunker(size_t minimum = MINIMUM, size_t average = AVERAGE,
+      size_t maximum = MAXIMUM) :
+    boundaries(minimum, average, maximum) {
+    Algorithm::init(state, Algorithm::SEED);
+  }
+
+  /**
+   * @brief Add the next characters of the stream
+   *
+   * @tparam Function callable as function(const Chunk &)
+   * @param c array to add
+   * @param length number of characters
+   * @param function to call with each chunk ended in order
+   */
+  template <class Function>
+  void add(const char * c, size_t length, Function function) {
+    while (length > 0) {
+      size_t consumed = 0;
+      bool   ended    = boundaries.find(c, length, consumed);
+      Algorithm::update(state, c, consumed);
+      chunkLength += consumed;
+      if (ended)
+        emit(function);
+      c += consumed;
+      length -= consumed;
+    }
+  }
+
+  /**
+   * @brief Add the next characters of the stream
+   *
+   * @param c array to add
+   * @param length number of characters
+   * @param chunks output, each chunk ended is appended in order
+   */
+  void add(const char * c, size_t length, std::vector<Chunk> & chunks) {
+    add(c, length, [&](const Chunk & chunk) { chunks.push_back(chunk); });
+  }
+
+  /**
+   * @brief End the stream, the characters after the last boundary are the
+   * final chunk if there are any
+   * The chunker then starts a new stream at offset 0
+   *
+   * @tparam Function callable as function(const Chunk &)
+   * @param function to call with the final chunk
+   */
+  template <class Function>
+  void finish(Function function) {
+    if (chunkLength > 0)
+      emit(function);
+    boundaries.reset();
+    offset = 0;
+  }
+
+  /**
+   * @brief End the stream
+   *
+   * @param chunks output, the final chunk is appended if there is one
+   */
+  void finish(std::vector<Chunk> & chunks) {
+    finish([&](const Chunk & chunk) { chunks.push_back(chunk); });
+  }
+
+private:
+  /**
+   * @brief Pass the current chunk to a function and start the next
+   *
+   * @tparam Function callable as function(const Chunk &)
+   * @param function to call
+   */
+  template <class Function>
+  void emit(Function function) {
+    Chunk chunk = {offset, chunkLength, Algorithm::finish(state)};
+    function(chunk);
+    offset += chunkLength;
+    chunkLength = 0;
+    Algorithm::init(state, Algorithm::SEED);
+  }
+
+  ChunkBoundaries             boundaries;
+  typename Algorithm::State_t state;
+  uint64_t                    offset      = 0;
+  size_t                      chunkLength = 0;
+};
+
+template <class Algorithm>
+const size_t BasicChunker<Algorithm>::MINIMUM;
+template <class Algorithm>
+const size_t BasicChunker<Algorithm>::AVERAGE;
+template <class Algorithm>
+const size_t BasicChunker<Algorithm>::MAXIMUM;
+
+typedef BasicChunker<Jenkins> Chunker;
+typedef BasicChunker<XXH64>   ChunkerXXH64;
+typedef BasicChunker<WyHash>  ChunkerWy;
+
+#endif /* _FB_CHUNKER_H_ */
@@ -0,0 +1,508 @@
+#ifndef _FB_EXPECTED_H_
+#define _FB_EXPECTED_H_
+
+#include "Result.h"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Warn if a value of the marked type or function is discarded
+ */
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(nodiscard)
+#define FB_NODISCARD [[nodiscard]]
+#endif
+#endif
+#ifndef FB_NODISCARD
+#define FB_NODISCARD
+#endif
+
+template <typename T, typename Error = Result>
+class Expected;
+
+namespace ExpectedDetail {
+
+/**
+ * @brief Get if an error is a failure
+ *
+ * @param error to test
+ * @return true if the error is not SUCCESS
+ */
+inline bool isFailure(ResultCode_t error) {
+  return error != ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Get if an error is a failure
+ *
+ * @param error to test
+ * @return true if the error is not SUCCESS
+ */
+inline bool isFailure(const Result & error) {
+  return !error;
+}
+
+/**
+ * @brief Convert a failed Result to an error
+ * A SUCCESS result is converted to INVALID_STATE, as it would not be an error
+ *
+ * @tparam Error type of the error
+ * @param error to convert, moved from
+ * @return Error failure
+ */
+template <typename Error>
+Error toError(Result && error) {
+  if (error)
+    return ResultCode_t::INVALID_STATE + "Expected a failure";
+  return std::move(error);
+}
+
+template <>
+inline ResultCode_t toError<ResultCode_t>(Result && error) {
+  ResultCode_t code = error.getCode();
+  return code == ResultCode_t::SUCCESS ? ResultCode_t::INVALID_STATE : code;
+}
+
+/**
+ * @brief Convert a code to an error, counting it as a new failure
+ * A SUCCESS code is converted to INVALID_STATE, as it would not be an error
+ *
+ * @tparam Error type of the error
+ * @param error to convert
+ * @return Error failure
+ */
+template <typename Error>
+Error toError(ResultCode_t error) {
+  return Result(
+      error == ResultCode_t::SUCCESS ? ResultCode_t::INVALID_STATE : error);
+}
+
+template <>
+inline ResultCode_t toError<ResultCode_t>(ResultCode_t error) {
+  if (error == ResultCode_t::SUCCESS)
+    error = ResultCode_t::INVALID_STATE;
+  Result::countFailure(error);
+  return error;
+}
+
+/**
+ * @brief Convert an existing error to a Result, not counted as a new failure
+ *
+ * @param error to convert
+ * @return Result holding the error's code
+ */
+inline Result toResult(ResultCode_t error) {
+  return Result::forward(error);
+}
+
+/**
+ * @brief Convert an existing error to a Result
+ *
+ * @param error to copy
+ * @return const Result& error
+ */
+inline const Result & toResult(const Result & error) {
+  return error;
+}
+
+/**
+ * @brief Storage of a value or an error
+ * The error is SUCCESS while holding the value, so no other flag is needed.
+ * The trivial specialization keeps every special member trivial, making the
+ * whole object trivially copyable.
+ *
+ * @tparam T type of the value
+ * @tparam Error type of the error
+ * @tparam Trivial true if T and Error are trivially copyable
+ */
+template <typename T, typename Error,
+    bool Trivial = std::is_trivially_copyable<T>::value &&
+                   std::is_trivially_copyable<Error>::value>
+struct Storage {
+  union {
+    T    value;
+    char empty;
+  };
+  Error error;
+
+  /**
+   * @brief Construct storage holding a value
+   *
+   * @param args to construct the value with
+   */
+  template <typename... Args>
+  explicit Storage(std::true_type, Args &&... args) :
+    value(std::forward<Args>(args)...), error(ResultCode_t::SUCCESS) {}
+
+  /**
+   * @brief Construct storage holding an error
+   *
+   * @param error to hold, a failure
+   */
+  explicit Storage(std::false_type, Error error) :
+    empty(0), error(std::move(error)) {}
+};
+
+template <typename T, typename Error>
+struct Storage<T, Error, false> {
+  union {
+    T    value;
+    char empty;
+  };
+  Error error;
+
+  /**
+   * @brief Construct storage holding a value
+   *
+   * @param args to construct the value with
+   */
+  template <typename... Args>
+  explicit Storage(std::true_type, Args &&... args) :
+    value(std::forward<Args>(args)...), error(ResultCode_t::SUCCESS) {}
+
+  /**
+   * @brief Construct storage holding an error
+   *
+   * @param error to hold, a failure
+   */
+  explicit Storage(std::false_type, Error error) :
+    empty(0), error(std::move(error)) {}
+
+  /**
+   * @brief Copy constructor
+   *
+   * @param storage to copy
+   */
+  Storage(const Storage & storage) : empty(0), error(storage.error) {
+    if (!isFailure(error))
+      new (&value) T(storage.value);
+  }
+
+  /**
+   * @brief Move constructor
+   * The other storage keeps its (moved from) value or its error
+   *
+   * @param storage to move
+   */
+  Storage(Storage && storage) noexcept(
+      std::is_nothrow_move_constructible<T>::value) :
+    empty(0),
+    error(storage.error) {
+    if (!isFailure(error))
+      new (&value) T(std::move(storage.value));
+  }
+
+  /**
+   * @brief Assignment operator
+   * If copying the value throws, an INVALID_STATE error is held
+   *
+   * @param storage to copy
+   * @return Storage&
+   */
+  Storage & operator=(const Storage & storage) {
+    if (this != &storage) {
+      destroy();
+      // Hold no value while constructing, in case T's constructor throws
+      error = toError<Error>(Result::forward(ResultCode_t::INVALID_STATE));
+      if (!isFailure(storage.error))
+        new (&value) T(storage.value);
+      error = storage.error;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment operator
+   * If moving the value throws, an INVALID_STATE error is held
+   *
+   * @param storage to move
+   * @return Storage&
+   */
+  Storage & operator=(Storage && storage) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &storage) {
+      destroy();
+      // Hold no value while constructing, in case T's constructor throws
+      error = toError<Error>(Result::forward(ResultCode_t::INVALID_STATE));
+      if (!isFailure(storage.error))
+        new (&value) T(std::move(storage.value));
+      error = storage.error;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Destroy the Storage object, and its value if held
+   */
+  ~Storage() {
+    destroy();
+  }
+
+  /**
+   * @brief Destroy the value if held
+   */
+  void destroy() {
+    if (!isFailure(error))
+      value.~T();
+  }
+};
+
+/**
+ * @brief Get the Expected type returned by a function
+ */
+template <typename T>
+struct IsExpected : std::false_type {};
+
+template <typename T, typename Error>
+struct IsExpected<Expected<T, Error>> : std::true_type {};
+
+} // namespace ExpectedDetail
+
+/**
+ * @brief Holds either a value or an error, returned instead of a Result and an
+ * output parameter
+ * The error is a Result (with its message) or only a ResultCode_t. With a
+ * ResultCode_t and a trivially copyable value, an Expected is itself
+ * trivially copyable, so small ones are returned in registers. It converts to
+ * an Expected with a Result error, adding a message costs the conversion.
+ *
+ * @tparam T type of the value, may be move only
+ * @tparam Error Result or ResultCode_t
+ */
+template <typename T, typename Error>
+class FB_NODISCARD Expected {
+  static_assert(std::is_same<Error, Result>::value ||
+                    std::is_same<Error, ResultCode_t>::value,
+      "The error of an Expected is a Result or ResultCode_t");
+
+public:
+  typedef T     Value_t;
+  typedef Error Error_t;
+
+  /**
+   * @brief Construct a new Expected object holding a value
+   *
+   * @param value to hold
+   */
+  Expected(const T & value) : storage(std::true_type(), value) {}
+
+  /**
+   * @brief Construct a new Expected object holding a value
+   *
+   * @param value to move in
+   */
+  Expected(T && value) : storage(std::true_type(), std::move(value)) {}
+
+  /**
+   * @brief Construct a new Expected object holding an error, a new failure
+   * A SUCCESS error is held as INVALID_STATE, as it would not be an error
+   *
+   * @param error to hold
+   */
+  Expected(ResultCode_t error) :
+    storage(std::false_type(), ExpectedDetail::toError<Error>(error)) {}
+
+  /**
+   * @brief Construct a new Expected object holding an error and its message
+   * A SUCCESS error is held as INVALID_STATE, as it would not be an error
+   *
+   * @param error to hold, only its code if Error is ResultCode_t
+   */
+  Expected(Result error) :
+    storage(
+        std::false_type(), ExpectedDetail::toError<Error>(std::move(error))) {}
+
+  /**
+   * @brief Converting constructor from an Expected with another error type
+   *
+   * @param expected to convert
+   */
+  template <typename Other,
+      typename = typename std::enable_if<
+          !std::is_same<Other, Error>::value>::type>
+  Expected(const Expected<T, Other> & expected) :
+    Expected(expected
+                 ? Expected(expected.getValue())
+                 : Expected(ExpectedDetail::toResult(expected.getError()))) {}
+
+  /**
+   * @brief Converting constructor from an Expected with another error type
+   *
+   * @param expected to move
+   */
+  template <typename Other,
+      typename = typename std::enable_if<
+          !std::is_same<Other, Error>::value>::type>
+  Expected(Expected<T, Other> && expected) :
+    Expected(expected
+                 ? Expected(std::move(expected).getValue())
+                 : Expected(ExpectedDetail::toResult(expected.getError()))) {}
+
+  /**
+   * @brief Bool cast operator (test for a value)
+   *
+   * @return true if a value is held
+   */
+  explicit inline operator bool() const {
+    return !ExpectedDetail::isFailure(storage.error);
+  }
+
+  /**
+   * @brief Get if a value is held
+   *
+   * @return true if a value is held
+   * @return false if an error is held
+   */
+  inline bool hasValue() const {
+    return !ExpectedDetail::isFailure(storage.error);
+  }
+
+  /**
+   * @brief Get the value, only valid if held
+   *
+   * @return T& value
+   */
+  inline T & getValue() & {
+    return storage.value;
+  }
+
+  /**
+   * @brief Get the value, only valid if held
+   *
+   * @return const T& value
+   */
+  inline const T & getValue() const & {
+    return storage.value;
+  }
+
+  /**
+   * @brief Get the value, only valid if held
+   *
+   * @return T&& value to move from
+   */
+  inline T && getValue() && {
+    return std::move(storage.value);
+  }
+
+  /**
+   * @brief Get the value or a fallback if an error is held
+   *
+   * @param fallback returned if an error is held
+   * @return T value or fallback
+   */
+  inline T getValueOr(T fallback) const & {
+    return hasValue() ? storage.value : fallback;
+  }
+
+  /**
+   * @brief Get the error, SUCCESS if a value is held
+   *
+   * @return const Error& error
+   */
+  inline const Error & getError() const {
+    return storage.error;
+  }
+
+  /**
+   * @brief Get the error as a Result, SUCCESS if a value is held
+   * The error is not counted again as a new failure
+   *
+   * @return Result
+   */
+  inline Result getResult() const {
+    return ExpectedDetail::toResult(storage.error);
+  }
+
+  /**
+   * @brief Apply a function to the value, keeping an error
+   *
+   * @tparam Function of const T &, returning a value
+   * @param function to apply
+   * @return Expected<U, Error> function's return value or the error
+   */
+  template <typename Function>
+  auto map(Function function) const & -> Expected<
+      typename std::decay<decltype(function(std::declval<const T &>()))>::type,
+      Error> {
+    if (hasValue())
+      return function(storage.value);
+    return getResult();
+  }
+
+  /**
+   * @brief Apply a function to the moved value, keeping an error
+   *
+   * @tparam Function of T &&, returning a value
+   * @param function to apply
+   * @return Expected<U, Error> function's return value or the error
+   */
+  template <typename Function>
+  auto map(Function function) && -> Expected<
+      typename std::decay<decltype(function(std::declval<T &&>()))>::type,
+      Error> {
+    if (hasValue())
+      return function(std::move(storage.value));
+    return getResult();
+  }
+
+  /**
+   * @brief Apply a function that may fail to the value, keeping an error
+   *
+   * @tparam Function of const T &, returning an Expected
+   * @param function to apply
+   * @return Expected function's return value or the error
+   */
+  template <typename Function>
+  auto andThen(Function function) const & ->
+      typename std::decay<decltype(function(std::declval<const T &>()))>::type {
+    typedef typename std::decay<decltype(function(
+        std::declval<const T &>()))>::type Return_t;
+    static_assert(ExpectedDetail::IsExpected<Return_t>::value,
+        "andThen's function returns an Expected");
+    if (hasValue())
+      return function(storage.value);
+    return Return_t(getResult());
+  }
+
+  /**
+   * @brief Apply a function that may fail to the moved value, keeping an
+   * error
+   *
+   * @tparam Function of T &&, returning an Expected
+   * @param function to apply
+   * @return Expected function's return value or the error
+   */
+  template <typename Function>
+  auto andThen(Function function) && ->
+      typename std::decay<decltype(function(std::declval<T &&>()))>::type {
+    typedef typename std::decay<decltype(function(
+        std::declval<T &&>()))>::type Return_t;
+    static_assert(ExpectedDetail::IsExpected<Return_t>::value,
+        "andThen's function returns an Expected");
+    if (hasValue())
+      return function(std::move(storage.value));
+    return Return_t(getResult());
+  }
+
+private:
+  ExpectedDetail::Storage<T, Error> storage;
+};
+
+/**
+ * @brief Addition operator for appending a string to an Expected's error
+ * A held value is kept unchanged
+ *
+ * @param left hand side - an Expected
+ * @param right hand side - a string to append
+ * @return Expected<T> combined result
+ */
+template <typename T, typename Error>
+Expected<T> operator+(Expected<T, Error> && left, const char * right) {
+  if (left)
+    return std::move(left).getValue();
+  return left.getResult() + right;
+}
+
+#endif /* _FB_EXPECTED_H_ */
@@ -0,0 +1,305 @@
+#include "File.h"
+
+#include <memory>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+namespace File {
+
+/**
+ * @brief Open file, its size is only known if regular
+ */
+struct Handle {
+#ifdef _WIN32
+  HANDLE file = INVALID_HANDLE_VALUE;
+#else
+  int file = -1;
+#endif /* _WIN32 */
+  uint64_t size    = 0;
+  bool     regular = false;
+
+  /**
+   * @brief Destroy the Handle object, closing the file
+   */
+  ~Handle() {
+#ifdef _WIN32
+    if (file != INVALID_HANDLE_VALUE)
+      CloseHandle(file);
+#else
+    if (file >= 0)
+      ::close(file);
+#endif /* _WIN32 */
+  }
+};
+
+/**
+ * @brief Open a file for sequential reading
+ *
+ * @param path of the file
+ * @param handle output
+ * @return Result OPEN_FAILED if the file cannot be opened
+ */
+static Result open(const std::string & path, Handle & handle) {
+#ifdef _WIN32
+  handle.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (handle.file == INVALID_HANDLE_VALUE)
+    return ResultCode_t::OPEN_FAILED + ("Could not open " + path);
+  LARGE_INTEGER size;
+  handle.regular = GetFileType(handle.file) == FILE_TYPE_DISK &&
+                   GetFileSizeEx(handle.file, &size);
+  handle.size = handle.regular ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+  do {
+    handle.file = ::open(path.c_str(), O_RDONLY);
+  } while (handle.file < 0 && errno == EINTR);
+  if (handle.file < 0)
+    return ResultCode_t::OPEN_FAILED + ("Could not open " + path);
+  struct stat status;
+  if (fstat(handle.file, &status) != 0)
+    return ResultCode_t::OPEN_FAILED + ("Could not stat " + path);
+  handle.regular = S_ISREG(status.st_mode);
+  handle.size    = handle.regular ? static_cast<uint64_t>(status.st_size) : 0;
+#if defined(POSIX_FADV_SEQUENTIAL)
+  posix_fadvise(handle.file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif /* POSIX_FADV_SEQUENTIAL */
+#endif /* _WIN32 */
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Get the current size of a regular file
+ *
+ * @param handle of the file
+ * @param size output number of characters
+ * @return true if the size is known
+ */
+static bool getSize(const Handle & handle, uint64_t & size) {
+#ifdef _WIN32
+  LARGE_INTEGER current;
+  if (!GetFileSizeEx(handle.file, &current))
+    return false;
+  size = static_cast<uint64_t>(current.QuadPart);
+#else
+  struct stat status;
+  if (fstat(handle.file, &status) != 0)
+    return false;
+  size = static_cast<uint64_t>(status.st_size);
+#endif /* _WIN32 */
+  return true;
+}
+
+/**
+ * @brief Pass a file to a function READ_CHUNK characters at a time
+ * Regular files are read up to the size when opened, others until the end
+ *
+ * @param handle of the file
+ * @param function to call with each chunk
+ * @param context to pass to function
+ * @return Result READ_FAULT if reading fails, END_OF_FILE if a regular file
+ * ends before its size
+ */
+static Result readChunks(
+    const Handle & handle, Chunk_t function, void * context) {
+  std::unique_ptr<char[]> buffer(new char[READ_CHUNK]);
+  uint64_t                position = 0;
+  while (!handle.regular || position < handle.size) {
+    size_t request = READ_CHUNK;
+    if (handle.regular && handle.size - position < request)
+      request = static_cast<size_t>(handle.size - position);
+#ifdef _WIN32
+    DWORD count = 0;
+    if (!ReadFile(handle.file, buffer.get(), static_cast<DWORD>(request),
+            &count, nullptr))
+      return ResultCode_t::READ_FAULT;
+#else
+    ssize_t count = ::read(handle.file, buffer.get(), request);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0)
+      return ResultCode_t::READ_FAULT;
+#endif /* _WIN32 */
+    if (count == 0)
+      break;
+    function(context, buffer.get(), static_cast<size_t>(count));
+    position += static_cast<uint64_t>(count);
+  }
+  if (handle.regular && position < handle.size)
+    return ResultCode_t::END_OF_FILE;
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Pass a regular file to a function MAP_WINDOW characters at a time
+ * from a memory mapping
+ * The size is checked again before each window is mapped, as touching pages
+ * past the end of a file that shrank faults (SIGBUS). A file shrinking while
+ * a window is passed to the function still faults.
+ *
+ * @param handle of the file
+ * @param function to call with each window
+ * @param context to pass to function
+ * @return Result NOT_SUPPORTED if the file cannot be mapped, READ_FAULT if a
+ * later window cannot be mapped, END_OF_FILE if the file shrank
+ */
+static Result mapChunks(
+    const Handle & handle, Chunk_t function, void * context) {
+  if (handle.size == 0)
+    return ResultCode_t::SUCCESS;
+#ifdef _WIN32
+  HANDLE mapping = CreateFileMappingA(
+      handle.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr)
+    return ResultCode_t::NOT_SUPPORTED;
+#endif /* _WIN32 */
+
+  Result result = ResultCode_t::SUCCESS;
+  for (uint64_t position = 0; position < handle.size; position += MAP_WINDOW) {
+    size_t length = MAP_WINDOW;
+    if (handle.size - position < length)
+      length = static_cast<size_t>(handle.size - position);
+    uint64_t size = 0;
+    if (!getSize(handle, size)) {
+      result = ResultCode_t::READ_FAULT;
+      break;
+    }
+    if (size < position + length) {
+      result = ResultCode_t::END_OF_FILE;
+      break;
+    }
+#ifdef _WIN32
+    void * view = MapViewOfFile(mapping, FILE_MAP_READ,
+        static_cast<DWORD>(position >> 32), static_cast<DWORD>(position),
+        length);
+    if (view == nullptr) {
+      result = position == 0 ? ResultCode_t::NOT_SUPPORTED
+                             : ResultCode_t::READ_FAULT;
+      break;
+    }
+    function(context, static_cast<const char *>(view), length);
+    UnmapViewOfFile(view);
+#else
+    void * view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, handle.file,
+        static_cast<off_t>(position));
+    if (view == MAP_FAILED) {
+      result = position == 0 ? ResultCode_t::NOT_SUPPORTED
+                             : ResultCode_t::READ_FAULT;
+      break;
+    }
+    madvise(view, length, MADV_SEQUENTIAL);
+    function(context, static_cast<const char *>(view), length);
+    munmap(view, length);
+#endif /* _WIN32 */
+  }
+
+#ifdef _WIN32
+  CloseHandle(mapping);
+#endif /* _WIN32 */
+  return result;
+}
+
+/**
+ * @brief Pass every character of a file to a function, a chunk at a time
+ * Characters are not copied when mapped, and only into a reused buffer when
+ * read. Access_t::AUTO reads if the file cannot be mapped.
+ *
+ * @param path of the file
+ * @param function to call with each chunk in order
+ * @param context to pass to function
+ * @param access to the file
+ * @return Result OPEN_FAILED, READ_FAULT or END_OF_FILE if the file shrank
+ */
+Result read(const std::string & path, Chunk_t function, void * context,
+    Access_t access) {
+  Handle handle;
+  Result result = open(path, handle);
+  if (!result)
+    return result;
+
+  bool map = access == Access_t::MAP ||
+             (access == Access_t::AUTO && handle.regular &&
+                 handle.size >= MAP_MINIMUM);
+  if (map && handle.regular) {
+    result = mapChunks(handle, function, context);
+    if (result != ResultCode_t::NOT_SUPPORTED)
+      return result ? result : result + ("Could not map " + path);
+    if (access == Access_t::MAP)
+      return ResultCode_t::READ_FAULT + ("Could not map " + path);
+  } else if (map) {
+    return ResultCode_t::READ_FAULT + ("Could not map " + path);
+  }
+
+  result = readChunks(handle, function, context);
+  return result ? result : result + ("Could not read " + path);
+}
+
+/**
+ * @brief Map a whole regular file, replacing any current mapping
+ *
+ * @param path of the file
+ * @return Result OPEN_FAILED if the file cannot be opened, READ_FAULT if it
+ * cannot be mapped
+ */
+Result Mapping::open(const std::string & path) {
+  close();
+  Handle handle;
+  Result result = File::open(path, handle);
+  if (!result)
+    return result;
+  if (!handle.regular || handle.size > static_cast<size_t>(-1))
+    return ResultCode_t::READ_FAULT + ("Could not map " + path);
+  if (handle.size == 0)
+    return ResultCode_t::SUCCESS;
+
+  size_t length = static_cast<size_t>(handle.size);
+#ifdef _WIN32
+  HANDLE mapping = CreateFileMappingA(
+      handle.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void * view =
+      mapping == nullptr
+          ? nullptr
+          : MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, length);
+  if (mapping != nullptr)
+    CloseHandle(mapping);
+  if (view == nullptr)
+    return ResultCode_t::READ_FAULT + ("Could not map " + path);
+#else
+  void * view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, handle.file, 0);
+  if (view == MAP_FAILED)
+    return ResultCode_t::READ_FAULT + ("Could not map " + path);
+#endif /* _WIN32 */
+  data = static_cast<const char *>(view);
+  size = length;
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Unmap the file
+ */
+void Mapping::close() {
+  if (data != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<char *>(data), size);
+#endif /* _WIN32 */
+  }
+  data = nullptr;
+  size = 0;
+}
+
+} // namespace File
@@ -0,0 +1,179 @@
+#ifndef _FB_FILE_H_
+#define _FB_FILE_H_
+
+#include "CRC32C.h"
+#include "HashAlgorithm.h"
+#include "LiteHash.h"
+#include "Result.h"
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief Streaming of files in chunks without keeping a copy
+ * Each chunk is passed straight from the operating system, either a window of
+ * a memory mapping (read ahead sequentially) or a reused read buffer. Hash
+ * with a LiteHash or a checksum rather than Hash which copies every
+ * character.
+ *
+ * A mapped file that shrinks is found before each window is mapped and ends
+ * the read with END_OF_FILE, but shrinking while a window is being passed
+ * faults (SIGBUS on POSIX). Read files that may be truncated while read, such
+ * as logs, with Access_t::READ.
+ *
+ */
+namespace File {
+
+/**
+ * @brief How a file is accessed
+ */
+enum class Access_t : uint8_t {
+  AUTO, // Map files of at least MAP_MINIMUM characters, else read
+  MAP,  // Map MAP_WINDOW characters at a time, the file must not shrink
+  READ  // Read READ_CHUNK characters at a time into a buffer
+};
+
+/**
+ * @brief Number of characters mapped at a time, a multiple of the page size
+ * and the Windows allocation granularity
+ */
+static const size_t MAP_WINDOW = 64 << 20;
+
+/**
+ * @brief Smallest file mapped by Access_t::AUTO, smaller files read faster
+ * than they map
+ */
+static const size_t MAP_MINIMUM = 1 << 20;
+
+/**
+ * @brief Number of characters read at a time
+ */
+static const size_t READ_CHUNK = 1 << 20;
+
+/**
+ * @brief Read only memory mapping of a whole file
+ * The file may be closed and renamed while mapped, but must not shrink
+ */
+class Mapping {
+public:
+  /**
+   * @brief Construct a new empty Mapping object
+   */
+  Mapping() {}
+
+  /**
+   * @brief Move constructor
+   * Take the mapping from the other, leaving it empty
+   *
+   * @param mapping to move
+   */
+  Mapping(Mapping && mapping) noexcept :
+    data(mapping.data), size(mapping.size) {
+    mapping.data = nullptr;
+    mapping.size = 0;
+  }
+
+  Mapping(const Mapping & mapping) = delete;
+  Mapping & operator=(const Mapping & mapping) = delete;
+
+  /**
+   * @brief Destroy the Mapping object, unmapping the file
+   */
+  ~Mapping() {
+    close();
+  }
+
+  Result open(const std::string & path);
+  void   close();
+
+  /**
+   * @brief Get the characters of the file
+   *
+   * @return const char * first character, nullptr if not mapped or empty
+   */
+  inline const char * getData() const {
+    return data;
+  }
+
+  /**
+   * @brief Get the number of characters of the file
+   *
+   * @return size_t size
+   */
+  inline size_t getSize() const {
+    return size;
+  }
+
+private:
+  const char * data = nullptr;
+  size_t       size = 0;
+};
+
+/**
+ * @brief Function receiving each chunk of a file in order
+ */
+typedef void (*Chunk_t)(void * context, const char * c, size_t length);
+
+Result read(const std::string & path, Chunk_t function, void * context,
+    Access_t access = Access_t::AUTO);
+
+/**
+ * @brief Add every character of a file to a hash or checksum
+ *
+ * @tparam Sink with add(const char *, size_t), such as LiteHash or CRC32C
+ * @param path of the file
+ * @param sink to add to
+ * @param access to the file
+ * @return Result OPEN_FAILED, READ_FAULT or END_OF_FILE if the file shrank
+ */
+template <class Sink>
+Result add(const std::string & path, Sink & sink,
+    Access_t access = Access_t::AUTO) {
+  return read(
+      path,
+      [](void * context, const char * c, size_t length) {
+        static_cast<Sink *>(context)->add(c, length);
+      },
+      &sink, access);
+}
+
+/**
+ * @brief Calculate the hash of a file
+ * Equals Hash::get() of the file's characters
+ *
+ * @tparam Algorithm to calculate the hash with
+ * @param path of the file
+ * @param hash output, only written on success
+ * @param access to the file
+ * @return Result OPEN_FAILED, READ_FAULT or END_OF_FILE if the file shrank
+ */
+template <class Algorithm = Jenkins>
+Result hash(const std::string & path, typename Algorithm::Value_t & hash,
+    Access_t access = Access_t::AUTO) {
+  BasicLiteHash<Algorithm> lite;
+  Result                   result = add(path, lite, access);
+  if (result)
+    hash = lite.get();
+  return result;
+}
+
+/**
+ * @brief Calculate the CRC32C checksum of a file
+ *
+ * @param path of the file
+ * @param crc output, only written on success
+ * @param access to the file
+ * @return Result OPEN_FAILED, READ_FAULT or END_OF_FILE if the file shrank
+ */
+inline Result checksum(const std::string & path, uint32_t & crc,
+    Access_t access = Access_t::AUTO) {
+  CRC32C checksum;
+  Result result = add(path, checksum, access);
+  if (result)
+    crc = checksum.get();
+  return result;
+}
+
+} // namespace File
+
+#endif /* _FB_FILE_H_ */
@@ -1,8 +1,21 @@
 #ifndef _FB_FRUIT_BOWL_H_
 #define _FB_FRUIT_BOWL_H_
 
+#include "BloomFilter.h"
+#include "CRC32C.h"
+#include "Chunker.h"
+#include "Expected.h"
+#include "File.h"
 #include "Hash.h"
+#include "HashIndex.h"
+#include "HashMap.h"
+#include "InternTable.h"
+#include "LiteHash.h"
+#include "PerfectHash.h"
 #include "Result.h"
+#include "ResultLog.h"
+#include "Tokenizer.h"
+#include "UTF8.h"
 
 #ifndef FRUIT_BOWL_NO_CHRONO
 #include <chrono>
@@ -1,27 +1,65 @@
 #include "Hash.h"
+#include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <utility>
+
+/**
+ * @brief String reported by a hash that has been moved from
+ */
+static const std::string EMPTY_STRING;
 
 /**
  * @brief Construct a new Hash:: Hash object
  * Create a new referenceCount equal to 1
  *
- * @param value to initialize the hash to
+ * @param seed to initialize the hash to
  */
-Hash::Hash(HashValue_t value) :
-  value(value), referenceCount(new int16_t), string(new std::string) {
-  *referenceCount = 1;
+template <class Algorithm>
+BasicHash<Algorithm>::BasicHash(Seed_t seed) :
+  string(new std::string), referenceCount(new ReferenceCount) {
+  Algorithm::init(state, seed);
 }
 
+/**
+ * @brief Construct a new Hash:: Hash object referencing interned storage
+ * No reference count, the storage outlives the hash
+ *
+ * @param state of the algorithm after hashing the string
+ * @param interned string to reference
+ */
+template <class Algorithm>
+BasicHash<Algorithm>::BasicHash(const typename Algorithm::State_t & state,
+    const std::string * interned) :
+  state(state), string(const_cast<std::string *>(interned)) {}
+
 /**
  * @brief Copy constructor
  * Copy the values and increment referenceCount
  *
  * @param result to copy
  */
-Hash::Hash(const Hash & hash) :
-  value(hash.value), string(hash.string), referenceCount(hash.referenceCount) {
-  ++(*referenceCount);
+template <class Algorithm>
+BasicHash<Algorithm>::BasicHash(const BasicHash & hash) :
+  state(hash.state), string(hash.string), referenceCount(hash.referenceCount),
+  hashingDone(hash.hashingDone) {
+  if (referenceCount != nullptr)
+    referenceCount->increment();
+}
+
+/**
+ * @brief Move constructor
+ * Take the string and referenceCount from the other hash, leaving it without
+ * a string
+ *
+ * @param hash to move
+ */
+template <class Algorithm>
+BasicHash<Algorithm>::BasicHash(BasicHash && hash) noexcept :
+  state(hash.state), string(hash.string), referenceCount(hash.referenceCount),
+  hashingDone(hash.hashingDone) {
+  hash.string         = nullptr;
+  hash.referenceCount = nullptr;
 }
 
 /**
@@ -32,35 +70,67 @@ Hash::Hash(const Hash & hash) :
  * @param hash to assign
  * @return Hash&
  */
-Hash & Hash::operator=(const Hash & hash) {
+template <class Algorithm>
+BasicHash<Algorithm> & BasicHash<Algorithm>::operator=(
+    const BasicHash & hash) {
   if (this != &hash) {
-    if (referenceCount != nullptr && (--(*referenceCount)) <= 0) {
+    if (referenceCount != nullptr && referenceCount->decrement()) {
       delete referenceCount;
       delete string;
     }
-    value          = hash.value;
+    state          = hash.state;
     string         = hash.string;
     referenceCount = hash.referenceCount;
-    ++(*referenceCount);
+    hashingDone    = hash.hashingDone;
+    if (referenceCount != nullptr)
+      referenceCount->increment();
   }
   return *this;
 }
 
+/**
+ * @brief Move assignment operator
+ * Swap with the other hash, its destructor will release the left hand side
+ *
+ * @param hash to move
+ * @return Hash&
+ */
+template <class Algorithm>
+BasicHash<Algorithm> & BasicHash<Algorithm>::operator=(
+    BasicHash && hash) noexcept {
+  std::swap(state, hash.state);
+  std::swap(string, hash.string);
+  std::swap(referenceCount, hash.referenceCount);
+  std::swap(hashingDone, hash.hashingDone);
+  return *this;
+}
+
 /**
  * @brief Destroy the Result object
  * Decrement the reference counter and delete the memory if zero references
  *
  * Deletes the message string if present
  */
-Hash::~Hash() {
-  if (referenceCount != nullptr) {
-    (*referenceCount)--;
-    if (*referenceCount <= 0) {
-      delete referenceCount;
-      delete string;
-      referenceCount = nullptr;
-      string         = nullptr;
-    }
+template <class Algorithm>
+BasicHash<Algorithm>::~BasicHash() {
+  if (referenceCount != nullptr && referenceCount->decrement()) {
+    delete referenceCount;
+    delete string;
+    referenceCount = nullptr;
+    string         = nullptr;
+  }
+}
+
+/**
+ * @brief Give the hash a string of its own to append to
+ * A hash that has been moved from gets a new string, a hash of interned
+ * storage gets a copy of it
+ */
+template <class Algorithm>
+void BasicHash<Algorithm>::ownString() {
+  if (referenceCount == nullptr) {
+    string = string == nullptr ? new std::string : new std::string(*string);
+    referenceCount = new ReferenceCount;
   }
 }
 
@@ -69,9 +139,11 @@ Hash::~Hash() {
  *
  * @param c to add
  */
-void Hash::add(const char c) {
+template <class Algorithm>
+void BasicHash<Algorithm>::add(const char c) {
+  ownString();
   string->push_back(c);
-  value = calculateHash(value, c);
+  Algorithm::update(state, &c, 1);
 }
 
 /**
@@ -82,15 +154,14 @@ void Hash::add(const char c) {
  * @param end character will stop and not hash this character
  * @return size_t number of characters read
  */
-size_t Hash::add(const char * c, size_t length, const char end) {
-  size_t count = 0;
-  while (*c != end && length > 0) {
-    add(*c);
-    --length;
-    ++c;
-    ++count;
-  }
-  return count;
+template <class Algorithm>
+size_t BasicHash<Algorithm>::add(
+    const char * c, size_t length, const char end) {
+  const void * found = memchr(c, end, length);
+  if (found != nullptr)
+    length = static_cast<size_t>(static_cast<const char *>(found) - c);
+  add(c, length);
+  return length;
 }
 
 /**
@@ -101,38 +172,34 @@ size_t Hash::add(const char * c, size_t length, const char end) {
  * @param end character will stop and not hash this character
  * @return size_t number of characters read
  */
-size_t Hash::add(const unsigned char * c, size_t length, const char end) {
-  size_t count = 0;
-  while (*c != end && length > 0) {
-    add(*c);
-    --length;
-    ++c;
-    ++count;
-  }
-  return count;
+template <class Algorithm>
+size_t BasicHash<Algorithm>::add(
+    const unsigned char * c, size_t length, const char end) {
+  return add(reinterpret_cast<const char *>(c), length, end);
 }
 
 /**
  * @brief Add a character array, length characters long
+ * Appends to the string once then hashes in a single loop
  *
  * @param c array to add
  * @param length number of characters
  */
-void Hash::add(const char * c, size_t length) {
-  while (length > 0) {
-    add(*c);
-    --length;
-    ++c;
-  }
+template <class Algorithm>
+void BasicHash<Algorithm>::add(const char * c, size_t length) {
+  ownString();
+  string->append(c, length);
+  Algorithm::update(state, c, length);
 }
 
 /**
  * @brief Get the current hash value
  *
- * @return const HashValue_t hash
+ * @return const Value_t hash
  */
-const HashValue_t Hash::get() const {
-  return finishHash(value);
+template <class Algorithm>
+const typename BasicHash<Algorithm>::Value_t BasicHash<Algorithm>::get() const {
+  return Algorithm::finish(state);
 }
 
 /**
@@ -140,16 +207,20 @@ const HashValue_t Hash::get() const {
  *
  * @return const std::string &
  */
-const std::string & Hash::getString() const {
+template <class Algorithm>
+const std::string & BasicHash<Algorithm>::getString() const {
+  if (string == nullptr)
+    return EMPTY_STRING;
   return *string;
 }
 
 /**
  * @brief Get reference count, number of references to string
  *
- * @return int16_t
+ * @return const ReferenceCount *
  */
-const int16_t * Hash::getReferenceCount() const {
+template <class Algorithm>
+const ReferenceCount * BasicHash<Algorithm>::getReferenceCount() const {
   return referenceCount;
 }
 
@@ -159,7 +230,8 @@ const int16_t * Hash::getReferenceCount() const {
  * @return true if hashing is complete
  * @return false if hashing is not complete
  */
-const bool Hash::isDone() const {
+template <class Algorithm>
+const bool BasicHash<Algorithm>::isDone() const {
   return hashingDone;
 }
 
@@ -168,6 +240,37 @@ const bool Hash::isDone() const {
  *
  * @param done if true will indicate hashing is complete
  */
-void Hash::setDone(const bool done) {
+template <class Algorithm>
+void BasicHash<Algorithm>::setDone(const bool done) {
   hashingDone = done;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Calculate the hash of many independent strings
+ *
+ * @param keys to hash
+ * @param count number of keys
+ * @param hashes output finished hash of each key
+ */
+template <class Algorithm>
+void BasicHash<Algorithm>::calculateHashes(
+    const std::string * keys, size_t count, Value_t * hashes) {
+  const size_t group = 64;
+  const char * pointers[group];
+  size_t       lengths[group];
+  while (count > 0) {
+    size_t n = count < group ? count : group;
+    for (size_t i = 0; i < n; ++i) {
+      pointers[i] = keys[i].c_str();
+      lengths[i]  = keys[i].length();
+    }
+    Algorithm::calculateHashes(pointers, lengths, n, hashes);
+    keys += n;
+    hashes += n;
+    count -= n;
+  }
+}
+
+template class BasicHash<Jenkins>;
+template class BasicHash<XXH64>;
+template class BasicHash<WyHash>;
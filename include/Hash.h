@@ -1,17 +1,33 @@
 #ifndef _FB_HASH_H_
 #define _FB_HASH_H_
 
+#include "HashAlgorithm.h"
+#include "ReferenceCount.h"
+
+#include <initializer_list>
 #include <stdint.h>
 #include <string>
 
-typedef uint32_t HashValue_t;
-
-class Hash {
+/**
+ * @brief Hash of a string, keeping a copy of the string
+ * The string is shared between copies of a hash, or is interned storage (see
+ * InternTable) not owned by any hash. The algorithm is a policy, see
+ * HashAlgorithm.h, Hash uses Jenkins.
+ *
+ * @tparam Algorithm to calculate the hash with
+ */
+template <class Algorithm>
+class BasicHash {
 public:
-  Hash(HashValue_t value = 0xFFFFFFFF);
-  Hash(const Hash & hash);
-  Hash & operator=(const Hash & hash);
-  ~Hash();
+  typedef typename Algorithm::Value_t Value_t;
+  typedef typename Algorithm::Seed_t  Seed_t;
+
+  BasicHash(Seed_t seed = Algorithm::SEED);
+  BasicHash(const BasicHash & hash);
+  BasicHash(BasicHash && hash) noexcept;
+  BasicHash & operator=(const BasicHash & hash);
+  BasicHash & operator=(BasicHash && hash) noexcept;
+  ~BasicHash();
 
   void   add(const char c);
   void   add(const char * c, size_t length);
@@ -27,75 +43,131 @@ public:
     add(str.c_str(), str.length());
   }
 
-  const HashValue_t   get() const;
-  const std::string & getString() const;
-  const int16_t *     getReferenceCount() const;
+  const Value_t          get() const;
+  const std::string &    getString() const;
+  const ReferenceCount * getReferenceCount() const;
 
   const bool isDone() const;
   void       setDone(const bool done);
 
+  /**
+   * @brief Get if the string is interned storage, see InternTable
+   * Interned hashes of the same table have equal strings if and only if
+   * &getString() are equal
+   *
+   * @return true if the string is interned, adding copies it first
+   * @return false if the string is owned (shared between copies)
+   */
+  inline bool isInterned() const {
+    return referenceCount == nullptr && string != nullptr;
+  }
+
   /**
    * @brief Calculate the hash from a string
    *
    * @param str to hash
-   * @return HashValue_t hash
+   * @return Value_t hash
    */
-  static HashValue_t calculateHash(const std::string & str) {
-    HashValue_t hash = 0xFFFFFFFF;
-    for (char c : str) {
-      hash = calculateHash(hash, c);
-    }
-    return finishHash(hash);
+  static Value_t calculateHash(const std::string & str) {
+    return Algorithm::calculate(str.c_str(), str.length());
   }
 
   /**
-   * @brief Calculate the hash from a string
+   * @brief Calculate the hash from a character array
    *
-   * @param string to hash
-   * @return constexpr HashValue_t hash
+   * @param c array to hash
+   * @param length number of characters
+   * @return Value_t hash
    */
-  static constexpr HashValue_t calculateHash(char * string) {
-    HashValue_t hash = 0xFFFFFFFF;
-    while (*string != '\0') {
-      hash = calculateHash(hash, *string);
-      ++string;
-    }
-    return finishHash(hash);
+  static Value_t calculateHash(const char * c, size_t length) {
+    return Algorithm::calculate(c, length);
   }
 
-private:
   /**
-   * @brief Calculate the hash through its algorithm on the seed hash and char
-   * Jenkin's hash function
+   * @brief Calculate the hash from a null terminated string
+   * Evaluated at compile time if the algorithm is constexpr
    *
-   * @param hash to seed
-   * @param c char to append
-   * @return constexpr HashValue_t hash
+   * @param string to hash
+   * @return constexpr Value_t hash
    */
-  static constexpr HashValue_t calculateHash(HashValue_t hash, const char c) {
-    hash = static_cast<HashValue_t>(hash + static_cast<uint64_t>(c));
-    hash = static_cast<HashValue_t>(hash + (static_cast<uint64_t>(hash) << 10));
-    hash = static_cast<HashValue_t>(hash ^ (static_cast<uint64_t>(hash) >> 6));
-    return hash;
+  static constexpr Value_t calculateHash(const char * string) {
+    size_t length = 0;
+    while (string[length] != '\0')
+      ++length;
+    return Algorithm::calculate(string, length);
   }
 
   /**
-   * @brief Applies final operations to finish creating a hash
+   * @brief Calculate the hash of many independent keys
    *
-   * @param hash to process
-   * @return constexpr HashValue_t final hash
+   * @param keys to hash
+   * @param lengths of each key
+   * @param count number of keys
+   * @param hashes output finished hash of each key
    */
-  static constexpr HashValue_t finishHash(HashValue_t hash) {
-    hash = static_cast<HashValue_t>(hash + (static_cast<uint64_t>(hash) << 3));
-    hash = static_cast<HashValue_t>(hash ^ (static_cast<uint64_t>(hash) >> 11));
-    hash = static_cast<HashValue_t>(hash + (static_cast<uint64_t>(hash) << 15));
-    return hash;
+  static void calculateHashes(const char * const * keys,
+      const size_t * lengths, size_t count, Value_t * hashes) {
+    Algorithm::calculateHashes(keys, lengths, count, hashes);
   }
 
-  HashValue_t   value;
-  std::string * string;
-  int16_t *     referenceCount = nullptr;
-  bool          hashingDone    = false;
+  static void calculateHashes(
+      const std::string * keys, size_t count, Value_t * hashes);
+
+private:
+  friend class InternTable;
+
+  BasicHash(const typename Algorithm::State_t & state,
+      const std::string * interned);
+
+  void ownString();
+
+  typename Algorithm::State_t state;
+  std::string *               string;
+  ReferenceCount *            referenceCount = nullptr;
+  bool                        hashingDone    = false;
 };
 
-#endif /* _FB_HASH_H_ */
\ No newline at end of file
+typedef BasicHash<Jenkins> Hash;
+typedef BasicHash<XXH64>   HashXXH64;
+typedef BasicHash<WyHash>  HashWy;
+
+extern template class BasicHash<Jenkins>;
+extern template class BasicHash<XXH64>;
+extern template class BasicHash<WyHash>;
+
+/**
+ * @brief Hash a string literal at compile time
+ * "name"_hash equals Hash::calculateHash("name") and Hash::get() after adding
+ * "name", so it can be used as a case label when switching on a hash
+ *
+ * @param string literal to hash
+ * @param length number of characters
+ * @return constexpr HashValue_t hash
+ */
+constexpr HashValue_t operator"" _hash(const char * string, size_t length) {
+  return Jenkins::calculate(string, length);
+}
+
+/**
+ * @brief Check a set of hashes for collisions
+ * Use in a static_assert over the literals of a switch to name the problem
+ * instead of a duplicate case value error. A string outside the set can still
+ * share a hash with one inside, compare Hash::getString() if that matters.
+ *
+ * @tparam Value_t type of the hashes
+ * @param hashes to check
+ * @return true if no two hashes are equal
+ * @return false if any two hashes are equal
+ */
+template <typename Value_t>
+constexpr bool hashesAreUnique(std::initializer_list<Value_t> hashes) {
+  for (const Value_t * i = hashes.begin(); i != hashes.end(); ++i) {
+    for (const Value_t * j = i + 1; j != hashes.end(); ++j) {
+      if (*i == *j)
+        return false;
+    }
+  }
+  return true;
+}
+
+#endif /* _FB_HASH_H_ */
@@ -0,0 +1,433 @@
+#include "HashAlgorithm.h"
+
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+constexpr Jenkins::Seed_t Jenkins::SEED;
+constexpr XXH64::Seed_t   XXH64::SEED;
+constexpr WyHash::Seed_t  WyHash::SEED;
+
+/**
+ * @brief Read 8 bytes as a little endian integer
+ *
+ * @param p bytes to read
+ * @return uint64_t value
+ */
+static inline uint64_t read64(const uint8_t * p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Read 4 bytes as a little endian integer
+ *
+ * @param p bytes to read
+ * @return uint64_t value
+ */
+static inline uint64_t read32(const uint8_t * p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Rotate bits left
+ *
+ * @param value to rotate
+ * @param bits to rotate by, 0 < bits < 64
+ * @return uint64_t rotated value
+ */
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+static const uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+/**
+ * @brief Accumulate 8 bytes into a lane
+ *
+ * @param accumulator of the lane
+ * @param input 8 bytes
+ * @return uint64_t accumulator
+ */
+static inline uint64_t xxhRound(uint64_t accumulator, uint64_t input) {
+  accumulator += input * XXH_PRIME2;
+  accumulator = rotateLeft(accumulator, 31);
+  return accumulator * XXH_PRIME1;
+}
+
+/**
+ * @brief Merge a lane into the hash
+ *
+ * @param hash to merge into
+ * @param accumulator of the lane
+ * @return uint64_t hash
+ */
+static inline uint64_t xxhMergeRound(uint64_t hash, uint64_t accumulator) {
+  hash ^= xxhRound(0, accumulator);
+  return hash * XXH_PRIME1 + XXH_PRIME4;
+}
+
+/**
+ * @brief Accumulate a 32 byte stripe into the four lanes
+ *
+ * @param accumulators of the lanes
+ * @param p 32 bytes
+ */
+static inline void xxhStripe(uint64_t accumulators[4], const uint8_t * p) {
+  accumulators[0] = xxhRound(accumulators[0], read64(p));
+  accumulators[1] = xxhRound(accumulators[1], read64(p + 8));
+  accumulators[2] = xxhRound(accumulators[2], read64(p + 16));
+  accumulators[3] = xxhRound(accumulators[3], read64(p + 24));
+}
+
+/**
+ * @brief Initialize the running state
+ *
+ * @param state to initialize
+ * @param seed to initialize to
+ */
+void XXH64::init(State_t & state, Seed_t seed) {
+  state.accumulators[0] = seed + XXH_PRIME1 + XXH_PRIME2;
+  state.accumulators[1] = seed + XXH_PRIME2;
+  state.accumulators[2] = seed;
+  state.accumulators[3] = seed - XXH_PRIME1;
+  state.seed            = seed;
+  state.length          = 0;
+  state.bufferLength    = 0;
+}
+
+/**
+ * @brief Add an array of characters to the running state
+ * Full stripes are read directly from the array, only a partial stripe is
+ * buffered
+ *
+ * @param state to update
+ * @param c array to add
+ * @param length number of characters
+ */
+void XXH64::update(State_t & state, const char * c, size_t length) {
+  const uint8_t * p   = reinterpret_cast<const uint8_t *>(c);
+  const uint8_t * end = p + length;
+  state.length += length;
+
+  if (state.bufferLength + length < 32) {
+    if (length > 0)
+      memcpy(state.buffer + state.bufferLength, p, length);
+    state.bufferLength += length;
+    return;
+  }
+
+  if (state.bufferLength > 0) {
+    size_t fill = 32 - state.bufferLength;
+    memcpy(state.buffer + state.bufferLength, p, fill);
+    xxhStripe(state.accumulators, state.buffer);
+    p += fill;
+    state.bufferLength = 0;
+  }
+
+  while (end - p >= 32) {
+    xxhStripe(state.accumulators, p);
+    p += 32;
+  }
+
+  state.bufferLength = static_cast<size_t>(end - p);
+  if (state.bufferLength > 0)
+    memcpy(state.buffer, p, state.bufferLength);
+}
+
+/**
+ * @brief Applies final operations to finish creating a hash
+ *
+ * @param state to process
+ * @return Value_t final hash
+ */
+XXH64::Value_t XXH64::finish(const State_t & state) {
+  uint64_t hash;
+  if (state.length >= 32) {
+    const uint64_t * v = state.accumulators;
+    hash = rotateLeft(v[0], 1) + rotateLeft(v[1], 7) + rotateLeft(v[2], 12) +
+           rotateLeft(v[3], 18);
+    hash = xxhMergeRound(hash, v[0]);
+    hash = xxhMergeRound(hash, v[1]);
+    hash = xxhMergeRound(hash, v[2]);
+    hash = xxhMergeRound(hash, v[3]);
+  } else {
+    hash = state.seed + XXH_PRIME5;
+  }
+  hash += state.length;
+
+  const uint8_t * p      = state.buffer;
+  size_t          length = state.bufferLength;
+  while (length >= 8) {
+    hash ^= xxhRound(0, read64(p));
+    hash = rotateLeft(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+    p += 8;
+    length -= 8;
+  }
+  if (length >= 4) {
+    hash ^= read32(p) * XXH_PRIME1;
+    hash = rotateLeft(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+    p += 4;
+    length -= 4;
+  }
+  while (length > 0) {
+    hash ^= (*p) * XXH_PRIME5;
+    hash = rotateLeft(hash, 11) * XXH_PRIME1;
+    ++p;
+    --length;
+  }
+
+  hash ^= hash >> 33;
+  hash *= XXH_PRIME2;
+  hash ^= hash >> 29;
+  hash *= XXH_PRIME3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+/**
+ * @brief Calculate the hash of an array of characters
+ *
+ * @param c array to hash
+ * @param length number of characters
+ * @return Value_t hash
+ */
+XXH64::Value_t XXH64::calculate(const char * c, size_t length) {
+  State_t state;
+  init(state, SEED);
+  update(state, c, length);
+  return finish(state);
+}
+
+/**
+ * @brief Calculate the hash of many independent keys
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param count number of keys
+ * @param hashes output finished hash of each key
+ */
+void XXH64::calculateHashes(const char * const * keys, const size_t * lengths,
+    size_t count, Value_t * hashes) {
+  for (size_t i = 0; i < count; ++i)
+    hashes[i] = calculate(keys[i], lengths[i]);
+}
+
+static const uint64_t WY_SECRET[4] = {0x2D358DCCAA6C78A5ULL,
+    0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL, 0x4D5A2DA51DE1AA47ULL};
+
+/**
+ * @brief Multiply two 64-bit integers into a 128-bit product
+ *
+ * @param a input, output low 64 bits of the product
+ * @param b input, output high 64 bits of the product
+ */
+static inline void wyMultiply(uint64_t & a, uint64_t & b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = static_cast<__uint128_t>(a) * b;
+  a                   = static_cast<uint64_t>(product);
+  b                   = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  a = _umul128(a, b, &b);
+#else
+  uint64_t aHigh = a >> 32, aLow = a & 0xFFFFFFFF;
+  uint64_t bHigh = b >> 32, bLow = b & 0xFFFFFFFF;
+  uint64_t high = aHigh * bHigh, middle0 = aHigh * bLow;
+  uint64_t middle1 = aLow * bHigh, low = aLow * bLow;
+  uint64_t carry = ((low >> 32) + (middle0 & 0xFFFFFFFF) +
+                       (middle1 & 0xFFFFFFFF)) >> 32;
+  a = low + (middle0 << 32) + (middle1 << 32);
+  b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+/**
+ * @brief Multiply and fold the 128-bit product to 64 bits
+ *
+ * @param a input
+ * @param b input
+ * @return uint64_t low ^ high
+ */
+static inline uint64_t wyMix(uint64_t a, uint64_t b) {
+  wyMultiply(a, b);
+  return a ^ b;
+}
+
+/**
+ * @brief Read 1 to 3 bytes
+ *
+ * @param p bytes to read
+ * @param length number of bytes, 1 to 3
+ * @return uint64_t value
+ */
+static inline uint64_t wyRead3(const uint8_t * p, size_t length) {
+  return (static_cast<uint64_t>(p[0]) << 16) |
+         (static_cast<uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+}
+
+/**
+ * @brief Mix a 48 byte block into the three lanes
+ *
+ * @param seed lane
+ * @param see1 lane
+ * @param see2 lane
+ * @param p 48 bytes
+ */
+static inline void wyBlock(
+    uint64_t & seed, uint64_t & see1, uint64_t & see2, const uint8_t * p) {
+  seed = wyMix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+  see1 = wyMix(read64(p + 16) ^ WY_SECRET[2], read64(p + 24) ^ see1);
+  see2 = wyMix(read64(p + 32) ^ WY_SECRET[3], read64(p + 40) ^ see2);
+}
+
+/**
+ * @brief Finish the hash from the remaining characters
+ *
+ * @param seed lane with see1 and see2 folded in
+ * @param p remaining characters, the 16 before are readable if length > 16
+ * @param remaining number of remaining characters
+ * @param length total number of characters
+ * @return uint64_t hash
+ */
+static inline uint64_t wyFinish(
+    uint64_t seed, const uint8_t * p, size_t remaining, uint64_t length) {
+  uint64_t a;
+  uint64_t b;
+  if (length <= 16) {
+    if (length >= 4) {
+      size_t offset = (length >> 3) << 2;
+      a             = (read32(p) << 32) | read32(p + offset);
+      b = (read32(p + length - 4) << 32) | read32(p + length - 4 - offset);
+    } else if (length > 0) {
+      a = wyRead3(p, length);
+      b = 0;
+    } else {
+      a = 0;
+      b = 0;
+    }
+  } else {
+    while (remaining > 16) {
+      seed = wyMix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+    a = read64(p + remaining - 16);
+    b = read64(p + remaining - 8);
+  }
+  a ^= WY_SECRET[1];
+  b ^= seed;
+  wyMultiply(a, b);
+  return wyMix(a ^ WY_SECRET[0] ^ length, b ^ WY_SECRET[1]);
+}
+
+/**
+ * @brief Initialize the running state
+ *
+ * @param state to initialize
+ * @param seed to initialize to
+ */
+void WyHash::init(State_t & state, Seed_t seed) {
+  state.seed         = seed ^ wyMix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+  state.see1         = state.seed;
+  state.see2         = state.seed;
+  state.length       = 0;
+  state.bufferLength = 0;
+}
+
+/**
+ * @brief Add an array of characters to the running state
+ * A block is only processed once more characters follow it, the final step
+ * treats the last 1 to 48 characters differently
+ *
+ * @param state to update
+ * @param c array to add
+ * @param length number of characters
+ */
+void WyHash::update(State_t & state, const char * c, size_t length) {
+  const uint8_t * p       = reinterpret_cast<const uint8_t *>(c);
+  uint8_t *       pending = state.buffer + 16;
+  state.length += length;
+
+  while (length > 0) {
+    if (state.bufferLength == 48) {
+      wyBlock(state.seed, state.see1, state.see2, pending);
+      memcpy(state.buffer, pending + 32, 16);
+      state.bufferLength = 0;
+    }
+    if (state.bufferLength == 0 && length > 48) {
+      do {
+        wyBlock(state.seed, state.see1, state.see2, p);
+        p += 48;
+        length -= 48;
+      } while (length > 48);
+      memcpy(state.buffer, p - 16, 16);
+    }
+    size_t count = 48 - state.bufferLength;
+    count        = length < count ? length : count;
+    memcpy(pending + state.bufferLength, p, count);
+    state.bufferLength += count;
+    p += count;
+    length -= count;
+  }
+}
+
+/**
+ * @brief Applies final operations to finish creating a hash
+ *
+ * @param state to process
+ * @return Value_t final hash
+ */
+WyHash::Value_t WyHash::finish(const State_t & state) {
+  uint64_t seed = state.seed;
+  if (state.length > 48)
+    seed ^= state.see1 ^ state.see2;
+  return wyFinish(
+      seed, state.buffer + 16, state.bufferLength, state.length);
+}
+
+/**
+ * @brief Calculate the hash of an array of characters
+ *
+ * @param c array to hash
+ * @param length number of characters
+ * @return Value_t hash
+ */
+WyHash::Value_t WyHash::calculate(const char * c, size_t length) {
+  const uint8_t * p = reinterpret_cast<const uint8_t *>(c);
+  uint64_t seed = SEED ^ wyMix(SEED ^ WY_SECRET[0], WY_SECRET[1]);
+  size_t   remaining = length;
+  if (remaining > 48) {
+    uint64_t see1 = seed;
+    uint64_t see2 = seed;
+    do {
+      wyBlock(seed, see1, see2, p);
+      p += 48;
+      remaining -= 48;
+    } while (remaining > 48);
+    seed ^= see1 ^ see2;
+  }
+  return wyFinish(seed, p, remaining, length);
+}
+
+/**
+ * @brief Calculate the hash of many independent keys
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param count number of keys
+ * @param hashes output finished hash of each key
+ */
+void WyHash::calculateHashes(const char * const * keys, const size_t * lengths,
+    size_t count, Value_t * hashes) {
+  for (size_t i = 0; i < count; ++i)
+    hashes[i] = calculate(keys[i], lengths[i]);
+}
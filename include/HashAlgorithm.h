@@ -0,0 +1,183 @@
+#ifndef _FB_HASH_ALGORITHM_H_
+#define _FB_HASH_ALGORITHM_H_
+
+#include <stdint.h>
+#include <string>
+
+typedef uint32_t HashValue_t;
+
+/**
+ * Hash algorithms are policies for BasicHash and BasicLiteHash. Each provides
+ *   Value_t  type of a finished hash
+ *   Seed_t   type of the seed, SEED the default
+ *   State_t  running state, updated in place
+ *   init(state, seed), update(state, c, length), finish(state) for streaming
+ *   calculate(c, length) for one shot
+ *   calculateHashes(keys, lengths, count, hashes) for many keys
+ */
+
+/**
+ * @brief Jenkins' one at a time hash
+ * 32-bit value processed one character at a time, the original algorithm of
+ * Hash. Every operation is constexpr.
+ *
+ */
+struct Jenkins {
+  typedef HashValue_t Value_t;
+  typedef HashValue_t Seed_t;
+  typedef HashValue_t State_t;
+
+  static constexpr Seed_t SEED = 0xFFFFFFFF;
+
+  /**
+   * @brief Initialize the running state
+   *
+   * @param hash state to initialize
+   * @param seed to initialize to
+   */
+  static constexpr void init(State_t & hash, Seed_t seed) {
+    hash = seed;
+  }
+
+  /**
+   * @brief Calculate the hash through its algorithm on the seed hash and char
+   *
+   * @param hash to seed
+   * @param c char to append
+   * @return constexpr State_t hash
+   */
+  static constexpr State_t step(State_t hash, const char c) {
+    hash = static_cast<State_t>(hash + static_cast<uint64_t>(c));
+    hash = static_cast<State_t>(hash + (static_cast<uint64_t>(hash) << 10));
+    hash = static_cast<State_t>(hash ^ (static_cast<uint64_t>(hash) >> 6));
+    return hash;
+  }
+
+  /**
+   * @brief Calculate the hash through its algorithm on the seed hash and an
+   * array of characters
+   * Each character depends on the previous so unrolling only removes the loop
+   * overhead
+   *
+   * @param hash to update
+   * @param c array to append
+   * @param length number of characters
+   */
+  static constexpr void update(State_t & hash, const char * c, size_t length) {
+    State_t      value = hash;
+    const char * end   = c + length;
+    while (end - c >= 8) {
+      value = step(value, c[0]);
+      value = step(value, c[1]);
+      value = step(value, c[2]);
+      value = step(value, c[3]);
+      value = step(value, c[4]);
+      value = step(value, c[5]);
+      value = step(value, c[6]);
+      value = step(value, c[7]);
+      c += 8;
+    }
+    while (c != end) {
+      value = step(value, *c);
+      ++c;
+    }
+    hash = value;
+  }
+
+  /**
+   * @brief Applies final operations to finish creating a hash
+   *
+   * @param hash to process
+   * @return constexpr Value_t final hash
+   */
+  static constexpr Value_t finish(State_t hash) {
+    hash = static_cast<State_t>(hash + (static_cast<uint64_t>(hash) << 3));
+    hash = static_cast<State_t>(hash ^ (static_cast<uint64_t>(hash) >> 11));
+    hash = static_cast<State_t>(hash + (static_cast<uint64_t>(hash) << 15));
+    return hash;
+  }
+
+  /**
+   * @brief Calculate the hash of an array of characters
+   *
+   * @param c array to hash
+   * @param length number of characters
+   * @return constexpr Value_t hash
+   */
+  static constexpr Value_t calculate(const char * c, size_t length) {
+    State_t hash = SEED;
+    update(hash, c, length);
+    return finish(hash);
+  }
+
+  static void calculateHashes(const char * const * keys,
+      const size_t * lengths, size_t count, Value_t * hashes);
+};
+
+/**
+ * @brief xxHash's XXH64
+ * 64-bit value processed in 32 byte stripes of four 64-bit lanes. Values match
+ * the reference implementation for little endian processors.
+ *
+ */
+struct XXH64 {
+  typedef uint64_t Value_t;
+  typedef uint64_t Seed_t;
+
+  /**
+   * @brief Running state, accumulators and characters not yet forming a full
+   * stripe
+   */
+  struct State_t {
+    uint64_t accumulators[4];
+    uint64_t seed;
+    uint64_t length;
+    uint8_t  buffer[32];
+    size_t   bufferLength;
+  };
+
+  static constexpr Seed_t SEED = 0;
+
+  static void    init(State_t & state, Seed_t seed);
+  static void    update(State_t & state, const char * c, size_t length);
+  static Value_t finish(const State_t & state);
+  static Value_t calculate(const char * c, size_t length);
+  static void    calculateHashes(const char * const * keys,
+         const size_t * lengths, size_t count, Value_t * hashes);
+};
+
+/**
+ * @brief Wang Yi's wyhash (final version 4)
+ * 64-bit value processed 48 bytes at a time with 64x64 to 128-bit multiplies,
+ * fastest on short keys.
+ *
+ */
+struct WyHash {
+  typedef uint64_t Value_t;
+  typedef uint64_t Seed_t;
+
+  /**
+   * @brief Running state, the three lanes and the characters not yet
+   * processed. The last 16 processed characters are kept since the final
+   * step reads the last 16 characters of the input.
+   */
+  struct State_t {
+    uint64_t seed;
+    uint64_t see1;
+    uint64_t see2;
+    uint64_t length;
+    uint8_t  buffer[64];
+    size_t   bufferLength;
+  };
+
+  static constexpr Seed_t SEED = 0;
+
+  static void    init(State_t & state, Seed_t seed);
+  static void    update(State_t & state, const char * c, size_t length);
+  static Value_t finish(const State_t & state);
+  static Value_t calculate(const char * c, size_t length);
+  static void    calculateHashes(const char * const * keys,
+         const size_t * lengths, size_t count, Value_t * hashes);
+};
+
+#endif /* _FB_HASH_ALGORITHM_H_ */
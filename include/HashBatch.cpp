@@ -0,0 +1,295 @@
+#include "CPU.h"
+#include "HashAlgorithm.h"
+
+#include <climits>
+#include <cstring>
+
+#ifdef FRUIT_BOWL_X86
+#include <immintrin.h>
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Longest key hashed in vector lanes, lengths are compared as signed
+ * 32-bit integers
+ */
+static const size_t MAX_LANE_LENGTH = 0x7FFFFFFF;
+
+#ifdef FRUIT_BOWL_X86
+/**
+ * @brief Load four characters of a key starting at position, padding with
+ * zeros past the end of the key
+ *
+ * @param key to read
+ * @param length of the key
+ * @param position of the first character
+ * @return uint32_t characters, first in the lowest byte
+ */
+static inline uint32_t loadWord(
+    const char * key, size_t length, size_t position) {
+  uint32_t word = 0;
+  if (position + 4 <= length)
+    memcpy(&word, key + position, 4);
+  else if (position < length)
+    memcpy(&word, key + position, length - position);
+  return word;
+}
+
+/**
+ * @brief Load the next four characters of each lane's key
+ *
+ * @param lanes number of keys
+ * @param keys to read
+ * @param lengths of each key
+ * @param position of the first character
+ * @param words output, one per lane
+ */
+static inline void loadWords(size_t lanes, const char * const * keys,
+    const size_t * lengths, size_t position, uint32_t * words) {
+  for (size_t i = 0; i < lanes; ++i)
+    words[i] = loadWord(keys[i], lengths[i], position);
+}
+
+/**
+ * @brief Get the longest length of each lane's key
+ *
+ * @param lanes number of keys
+ * @param lengths of each key
+ * @return size_t longest length
+ */
+static inline size_t maxLength(size_t lanes, const size_t * lengths) {
+  size_t length = 0;
+  for (size_t i = 0; i < lanes; ++i)
+    length = lengths[i] > length ? lengths[i] : length;
+  return length;
+}
+
+/**
+ * @brief Jenkins' step on 4 lanes, lanes not active keep their hash
+ *
+ * @param hash of each lane
+ * @param c character of each lane, converted like Jenkins::step
+ * @param active mask of lanes with a character at this position
+ * @return __m128i hash
+ */
+FB_TARGET("sse2")
+static inline __m128i stepSSE2(__m128i hash, __m128i c, __m128i active) {
+  __m128i next = _mm_add_epi32(hash, c);
+  next         = _mm_add_epi32(next, _mm_slli_epi32(next, 10));
+  next         = _mm_xor_si128(next, _mm_srli_epi32(next, 6));
+  return _mm_or_si128(
+      _mm_and_si128(active, next), _mm_andnot_si128(active, hash));
+}
+
+/**
+ * @brief Extract a character from each lane's word, sign extended if char is
+ * signed to match Jenkins::step
+ *
+ * @param word of 4 characters
+ * @param shift to move the character to the top byte
+ * @return __m128i characters
+ */
+FB_TARGET("sse2")
+static inline __m128i charSSE2(__m128i word, int shift) {
+  __m128i count = _mm_cvtsi32_si128(shift);
+  __m128i top   = _mm_sll_epi32(word, count);
+  return CHAR_MIN < 0 ? _mm_srai_epi32(top, 24) : _mm_srli_epi32(top, 24);
+}
+
+/**
+ * @brief Hash 4 keys at once with SSE2
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param hashes output finished hash of each key
+ */
+FB_TARGET("sse2")
+static void hashLanesSSE2(
+    const char * const * keys, const size_t * lengths, HashValue_t * hashes) {
+  const size_t lanes  = 4;
+  size_t       length = maxLength(lanes, lengths);
+  __m128i      hash   = _mm_set1_epi32(-1);
+
+  alignas(16) uint32_t words[lanes];
+  for (size_t i = 0; i < lanes; ++i)
+    words[i] = static_cast<uint32_t>(lengths[i]);
+  __m128i laneLength = _mm_load_si128(reinterpret_cast<const __m128i *>(words));
+
+  for (size_t position = 0; position < length; position += 4) {
+    loadWords(lanes, keys, lengths, position, words);
+    __m128i word = _mm_load_si128(reinterpret_cast<const __m128i *>(words));
+    for (int k = 0; k < 4; ++k) {
+      __m128i active = _mm_cmpgt_epi32(
+          laneLength, _mm_set1_epi32(static_cast<int>(position) + k));
+      hash = stepSSE2(hash, charSSE2(word, 24 - 8 * k), active);
+    }
+  }
+
+  hash = _mm_add_epi32(hash, _mm_slli_epi32(hash, 3));
+  hash = _mm_xor_si128(hash, _mm_srli_epi32(hash, 11));
+  hash = _mm_add_epi32(hash, _mm_slli_epi32(hash, 15));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(hashes), hash);
+}
+
+/**
+ * @brief Jenkins' step on 8 lanes, lanes not active keep their hash
+ *
+ * @param hash of each lane
+ * @param c character of each lane, converted like Jenkins::step
+ * @param active mask of lanes with a character at this position
+ * @return __m256i hash
+ */
+FB_TARGET("avx2")
+static inline __m256i stepAVX2(__m256i hash, __m256i c, __m256i active) {
+  __m256i next = _mm256_add_epi32(hash, c);
+  next         = _mm256_add_epi32(next, _mm256_slli_epi32(next, 10));
+  next         = _mm256_xor_si256(next, _mm256_srli_epi32(next, 6));
+  return _mm256_or_si256(
+      _mm256_and_si256(active, next), _mm256_andnot_si256(active, hash));
+}
+
+/**
+ * @brief Extract a character from each lane's word, sign extended if char is
+ * signed to match Jenkins::step
+ *
+ * @param word of 4 characters
+ * @param shift to move the character to the top byte
+ * @return __m256i characters
+ */
+FB_TARGET("avx2")
+static inline __m256i charAVX2(__m256i word, int shift) {
+  __m128i count = _mm_cvtsi32_si128(shift);
+  __m256i top   = _mm256_sll_epi32(word, count);
+  return CHAR_MIN < 0 ? _mm256_srai_epi32(top, 24)
+                      : _mm256_srli_epi32(top, 24);
+}
+
+/**
+ * @brief Hash 8 keys at once with AVX2
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param hashes output finished hash of each key
+ */
+FB_TARGET("avx2")
+static void hashLanesAVX2(
+    const char * const * keys, const size_t * lengths, HashValue_t * hashes) {
+  const size_t lanes  = 8;
+  size_t       length = maxLength(lanes, lengths);
+  __m256i      hash   = _mm256_set1_epi32(-1);
+
+  alignas(32) uint32_t words[lanes];
+  for (size_t i = 0; i < lanes; ++i)
+    words[i] = static_cast<uint32_t>(lengths[i]);
+  __m256i laneLength =
+      _mm256_load_si256(reinterpret_cast<const __m256i *>(words));
+
+  for (size_t position = 0; position < length; position += 4) {
+    loadWords(lanes, keys, lengths, position, words);
+    __m256i word =
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(words));
+    for (int k = 0; k < 4; ++k) {
+      __m256i active = _mm256_cmpgt_epi32(
+          laneLength, _mm256_set1_epi32(static_cast<int>(position) + k));
+      hash = stepAVX2(hash, charAVX2(word, 24 - 8 * k), active);
+    }
+  }
+
+  hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 3));
+  hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 11));
+  hash = _mm256_add_epi32(hash, _mm256_slli_epi32(hash, 15));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(hashes), hash);
+}
+
+/**
+ * @brief Hash 16 keys at once with AVX-512
+ * Lanes past the end of their key are masked off
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param hashes output finished hash of each key
+ */
+FB_TARGET("avx512f")
+static void hashLanesAVX512(
+    const char * const * keys, const size_t * lengths, HashValue_t * hashes) {
+  const size_t lanes  = 16;
+  size_t       length = maxLength(lanes, lengths);
+  __m512i      hash   = _mm512_set1_epi32(-1);
+
+  alignas(64) uint32_t words[lanes];
+  for (size_t i = 0; i < lanes; ++i)
+    words[i] = static_cast<uint32_t>(lengths[i]);
+  __m512i laneLength = _mm512_load_si512(words);
+
+  for (size_t position = 0; position < length; position += 4) {
+    loadWords(lanes, keys, lengths, position, words);
+    __m512i word = _mm512_load_si512(words);
+    for (int k = 0; k < 4; ++k) {
+      __mmask16 active = _mm512_cmpgt_epi32_mask(
+          laneLength, _mm512_set1_epi32(static_cast<int>(position) + k));
+      __m128i count = _mm_cvtsi32_si128(24 - 8 * k);
+      __m512i top   = _mm512_sll_epi32(word, count);
+      __m512i c     = CHAR_MIN < 0 ? _mm512_srai_epi32(top, 24)
+                                   : _mm512_srli_epi32(top, 24);
+
+      __m512i next = _mm512_add_epi32(hash, c);
+      next         = _mm512_add_epi32(next, _mm512_slli_epi32(next, 10));
+      next         = _mm512_xor_si512(next, _mm512_srli_epi32(next, 6));
+      hash         = _mm512_mask_mov_epi32(hash, active, next);
+    }
+  }
+
+  hash = _mm512_add_epi32(hash, _mm512_slli_epi32(hash, 3));
+  hash = _mm512_xor_si512(hash, _mm512_srli_epi32(hash, 11));
+  hash = _mm512_add_epi32(hash, _mm512_slli_epi32(hash, 15));
+  _mm512_storeu_si512(hashes, hash);
+}
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Check if every key of a group fits in a vector lane
+ *
+ * @param lanes number of keys
+ * @param lengths of each key
+ * @return true if every length can be compared as a signed 32-bit integer
+ * @return false otherwise
+ */
+static inline bool fitsLanes(size_t lanes, const size_t * lengths) {
+  for (size_t i = 0; i < lanes; ++i) {
+    if (lengths[i] > MAX_LANE_LENGTH)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Calculate the hash of many independent keys
+ * Groups of keys are hashed at once in vector lanes (AVX-512, AVX2 or SSE2 as
+ * supported by the processor), the remainder one at a time. The values are
+ * identical to calculate.
+ *
+ * @param keys to hash
+ * @param lengths of each key
+ * @param count number of keys
+ * @param hashes output finished hash of each key
+ */
+void Jenkins::calculateHashes(const char * const * keys,
+    const size_t * lengths, size_t count, Value_t * hashes) {
+  size_t i = 0;
+#ifdef FRUIT_BOWL_X86
+  const CPU::Features & cpu = CPU::getFeatures();
+  if (cpu.avx512f) {
+    for (; i + 16 <= count && fitsLanes(16, lengths + i); i += 16)
+      hashLanesAVX512(keys + i, lengths + i, hashes + i);
+  }
+  if (cpu.avx2) {
+    for (; i + 8 <= count && fitsLanes(8, lengths + i); i += 8)
+      hashLanesAVX2(keys + i, lengths + i, hashes + i);
+  }
+  if (cpu.sse2) {
+    for (; i + 4 <= count && fitsLanes(4, lengths + i); i += 4)
+      hashLanesSSE2(keys + i, lengths + i, hashes + i);
+  }
+#endif /* FRUIT_BOWL_X86 */
+  for (; i < count; ++i)
+    hashes[i] = calculate(keys[i], lengths[i]);
+}
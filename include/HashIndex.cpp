@@ -0,0 +1,245 @@
+#include "CRC32C.h"
+#include "HashIndex.h"
+#include "HashMap.h"
+
+#include <cstdio>
+#include <cstring>
+
+const char HashIndex::MAGIC[8] = {'F', 'B', 'I', 'N', 'D', 'E', 'X', '\0'};
+
+/**
+ * @brief Calculate the checksum of a header, excluding its own checksum
+ *
+ * @tparam Header type of the header, HashIndex::Header
+ * @param header to checksum
+ * @return uint32_t checksum
+ */
+template <class Header>
+static uint32_t headerChecksum(Header header) {
+  header.headerCRC = 0;
+  return CRC32C::calculate(
+      reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+/**
+ * @brief Map an index file and load it
+ *
+ * @param path of the file
+ * @param verify if true checksum every key and payload, else only the header
+ * @return Result OPEN_FAILED or READ_FAULT if the file cannot be mapped, see
+ * load
+ */
+Result HashIndex::open(const std::string & path, bool verify) {
+  close();
+  Result result = mapping.open(path);
+  if (result)
+    result = load(mapping.getData(), mapping.getSize(), verify);
+  if (!result) {
+    mapping.close();
+    return result + ("Could not load index " + path);
+  }
+  return result;
+}
+
+/**
+ * @brief Load an index from memory, which must outlive the index
+ * Only the header is read, the slots are queried in place
+ *
+ * @param data of the index file, aligned to 8 characters
+ * @param size number of characters
+ * @param verify if true checksum every key and payload, else only the header
+ * @return Result INVALID_DATA if not a valid index of this version, CRC if a
+ * checksum does not match, INVALID_PARAMETER if data is not aligned
+ */
+Result HashIndex::load(const char * data, size_t size, bool verify) {
+  this->data = nullptr;
+  dataSize   = 0;
+  slots      = nullptr;
+  capacity   = 0;
+  count      = 0;
+
+  Header header;
+  if (size < sizeof(Header))
+    return ResultCode_t::INVALID_DATA + "Index is smaller than its header";
+  memcpy(&header, data, sizeof(Header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    return ResultCode_t::INVALID_DATA + "Index does not start with FBINDEX";
+  if (header.headerCRC != headerChecksum(header))
+    return ResultCode_t::CRC + "Index header checksum does not match";
+  if (header.version != VERSION)
+    return ResultCode_t::INVALID_DATA +
+           ("Index version " + std::to_string(header.version) +
+               " is not supported");
+  if (reinterpret_cast<uintptr_t>(data) % alignof(Slot) != 0)
+    return ResultCode_t::INVALID_PARAMETER + "Index is not aligned";
+
+  uint64_t slotsSize = header.capacity * sizeof(Slot);
+  if (header.fileSize != size || header.capacity == 0 ||
+      (header.capacity & (header.capacity - 1)) != 0 ||
+      header.capacity > size / sizeof(Slot) || header.count > header.capacity ||
+      header.slotsOffset % alignof(Slot) != 0 ||
+      header.slotsOffset < sizeof(Header) ||
+      header.slotsOffset > size - slotsSize ||
+      header.dataOffset < header.slotsOffset + slotsSize ||
+      header.dataOffset > size)
+    return ResultCode_t::INVALID_DATA + "Index header is not consistent";
+
+  if (verify) {
+    uint32_t crc = CRC32C::calculate(
+        data + sizeof(Header), size - sizeof(Header));
+    if (crc != header.bodyCRC)
+      return ResultCode_t::CRC + "Index checksum does not match";
+  }
+
+  this->data = data;
+  dataSize   = size;
+  slots      = reinterpret_cast<const Slot *>(data + header.slotsOffset);
+  capacity   = header.capacity;
+  count      = header.count;
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Find the payload of a hashed key
+ * Stops at an empty slot or an entry closer to its home than the key would
+ * be, as Robin Hood insertion would have placed the key before it. Offsets
+ * outside the file are treated as not present.
+ *
+ * @param hash of the key
+ * @param key to find
+ * @param keyLength number of characters of the key
+ * @param length output number of characters of the payload
+ * @return const char * payload or nullptr if the key is not present
+ */
+const char * HashIndex::find(HashValue_t hash, const char * key,
+    size_t keyLength, size_t & length) const {
+  if (capacity == 0)
+    return nullptr;
+  size_t mask = static_cast<size_t>(capacity - 1);
+  size_t i    = home(hash, capacity);
+  for (uint64_t distance = 1;
+       slots[i].distance >= distance && distance <= capacity; ++distance) {
+    const Slot & slot = slots[i];
+    if (slot.hash == hash && slot.keyLength == keyLength &&
+        keyLength <= dataSize && slot.keyOffset <= dataSize - keyLength &&
+        memcmp(data + slot.keyOffset, key, keyLength) == 0) {
+      if (slot.payloadLength > dataSize ||
+          slot.payloadOffset > dataSize - slot.payloadLength)
+        return nullptr;
+      length = slot.payloadLength;
+      return data + slot.payloadOffset;
+    }
+    i = (i + 1) & mask;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Add a key and its payload, replacing the payload of an equal key
+ *
+ * @param key to add
+ * @param keyLength number of characters of the key
+ * @param payload of the key
+ * @param length number of characters of the payload
+ * @return Result INVALID_PARAMETER if the key or payload is 4 GB or longer
+ */
+Result HashIndexBuilder::add(const char * key, size_t keyLength,
+    const char * payload, size_t length) {
+  if (keyLength > UINT32_MAX || length > UINT32_MAX)
+    return ResultCode_t::INVALID_PARAMETER + "Index entries must be under 4 GB";
+  entries.push_back(Entry{Jenkins::calculate(key, keyLength),
+      std::string(key, keyLength), std::string(payload, length)});
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Create the index file in memory
+ *
+ * @param image output contents of the file
+ */
+void HashIndexBuilder::build(std::string & image) const {
+  typedef HashIndex::Header Header;
+  typedef HashIndex::Slot   Slot;
+
+  // The last payload of each key wins
+  HashMap<uint32_t> latest;
+  latest.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+    latest.set(entries[i].key, static_cast<uint32_t>(i));
+  std::vector<uint32_t> unique;
+  unique.reserve(latest.size());
+  latest.forEach(
+      [&](const std::string &, uint32_t & index) { unique.push_back(index); });
+
+  uint64_t capacity = 16;
+  while (unique.size() * 8 > capacity * 7)
+    capacity *= 2;
+  uint64_t dataOffset = sizeof(Header) + capacity * sizeof(Slot);
+  uint64_t size       = dataOffset;
+  for (uint32_t index : unique)
+    size += entries[index].key.length() + entries[index].payload.length();
+
+  image.assign(static_cast<size_t>(size), '\0');
+  std::vector<Slot> slots(static_cast<size_t>(capacity));
+  memset(slots.data(), 0, slots.size() * sizeof(Slot));
+  size_t   mask     = static_cast<size_t>(capacity - 1);
+  uint64_t position = dataOffset;
+  for (uint32_t index : unique) {
+    const Entry & entry = entries[index];
+    Slot          slot  = {entry.hash, 1,
+        static_cast<uint32_t>(entry.key.length()),
+        static_cast<uint32_t>(entry.payload.length()), position,
+        position + entry.key.length()};
+    memcpy(&image[static_cast<size_t>(position)], entry.key.data(),
+        entry.key.length());
+    memcpy(&image[static_cast<size_t>(slot.payloadOffset)],
+        entry.payload.data(), entry.payload.length());
+    position = slot.payloadOffset + entry.payload.length();
+
+    // Robin Hood: a slot further from its home takes the place of one closer
+    // to its home, which continues probing
+    size_t i = HashIndex::home(slot.hash, capacity);
+    while (slots[i].distance != 0) {
+      if (slots[i].distance < slot.distance)
+        std::swap(slot, slots[i]);
+      i = (i + 1) & mask;
+      ++slot.distance;
+    }
+    slots[i] = slot;
+  }
+  memcpy(&image[sizeof(Header)], slots.data(), slots.size() * sizeof(Slot));
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, HashIndex::MAGIC, sizeof(header.magic));
+  header.version     = HashIndex::VERSION;
+  header.fileSize    = size;
+  header.count       = unique.size();
+  header.capacity    = capacity;
+  header.slotsOffset = sizeof(Header);
+  header.dataOffset  = dataOffset;
+  header.bodyCRC     = CRC32C::calculate(
+      image.data() + sizeof(Header), image.size() - sizeof(Header));
+  header.headerCRC = headerChecksum(header);
+  memcpy(&image[0], &header, sizeof(header));
+}
+
+/**
+ * @brief Write the index file
+ *
+ * @param path of the file, replaced if it exists
+ * @return Result CANNOT_MAKE if the file cannot be created, WRITE_FAULT if it
+ * cannot be written
+ */
+Result HashIndexBuilder::write(const std::string & path) const {
+  std::string image;
+  build(image);
+  FILE * file = fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    return ResultCode_t::CANNOT_MAKE + ("Could not create " + path);
+  bool written = fwrite(image.data(), 1, image.size(), file) == image.size();
+  written      = fclose(file) == 0 && written;
+  if (!written)
+    return ResultCode_t::WRITE_FAULT + ("Could not write " + path);
+  return ResultCode_t::SUCCESS;
+}
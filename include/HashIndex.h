@@ -0,0 +1,199 @@
+#ifndef _FB_HASH_INDEX_H_
+#define _FB_HASH_INDEX_H_
+
+#include "File.h"
+#include "Hash.h"
+#include "Result.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Read only map from strings to payloads, stored in a file and queried
+ * in place
+ * The file is a header, Robin Hood slots (as HashMap) holding the hash (same
+ * as Hash) and the offsets of each key and payload, then the keys and
+ * payloads. Offsets are from the start of the file, so it is usable wherever
+ * it is mapped without deserializing. Integers are little endian. The header
+ * and the rest of the file each have a CRC32C checksum. Files are written by
+ * HashIndexBuilder.
+ *
+ */
+class HashIndex {
+public:
+  /**
+   * @brief Format version written by HashIndexBuilder and accepted by open
+   */
+  static const uint32_t VERSION = 1;
+
+  /**
+   * @brief Construct a new empty Hash Index object
+   */
+  HashIndex() {}
+
+  Result open(const std::string & path, bool verify = true);
+  Result load(const char * data, size_t size, bool verify = true);
+
+  /**
+   * @brief Find the payload of a key
+   * The string is hashed again as the index holds Jenkins of each key, a
+   * seeded Hash has another value
+   *
+   * @param key to find
+   * @param length output number of characters of the payload
+   * @return const char * payload or nullptr if the key is not present
+   */
+  inline const char * find(const Hash & key, size_t & length) const {
+    return find(key.getString(), length);
+  }
+
+  /**
+   * @brief Find the payload of a key
+   *
+   * @param key to find
+   * @param keyLength number of characters of the key
+   * @param length output number of characters of the payload
+   * @return const char * payload or nullptr if the key is not present
+   */
+  inline const char * find(
+      const char * key, size_t keyLength, size_t & length) const {
+    return find(Jenkins::calculate(key, keyLength), key, keyLength, length);
+  }
+
+  /**
+   * @brief Find the payload of a key
+   *
+   * @param key to find
+   * @param length output number of characters of the payload
+   * @return const char * payload or nullptr if the key is not present
+   */
+  inline const char * find(const std::string & key, size_t & length) const {
+    return find(key.c_str(), key.length(), length);
+  }
+
+  const char * find(HashValue_t hash, const char * key, size_t keyLength,
+      size_t & length) const;
+
+  /**
+   * @brief Unload the index, unmapping its file if opened
+   */
+  inline void close() {
+    mapping.close();
+    data     = nullptr;
+    dataSize = 0;
+    slots    = nullptr;
+    capacity = 0;
+    count    = 0;
+  }
+
+  /**
+   * @brief Get the number of keys
+   *
+   * @return size_t count
+   */
+  inline size_t size() const {
+    return count;
+  }
+
+private:
+  friend class HashIndexBuilder;
+
+  /**
+   * @brief Start of the file
+   */
+  struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t headerCRC;
+    uint64_t fileSize;
+    uint64_t count;
+    uint64_t capacity;
+    uint64_t slotsOffset;
+    uint64_t dataOffset;
+    uint32_t bodyCRC;
+    uint32_t reserved;
+  };
+
+  /**
+   * @brief Probe metadata and location of an entry
+   * distance is 1 for an entry in its home slot, 0 for an empty slot
+   */
+  struct Slot {
+    HashValue_t hash;
+    uint32_t    distance;
+    uint32_t    keyLength;
+    uint32_t    payloadLength;
+    uint64_t    keyOffset;
+    uint64_t    payloadOffset;
+  };
+
+  static const char MAGIC[8];
+
+  /**
+   * @brief Get the home slot of a hash, as HashMap
+   *
+   * @param hash of the key
+   * @param capacity number of slots, a power of 2
+   * @return size_t slot
+   */
+  static inline size_t home(HashValue_t hash, uint64_t capacity) {
+    return static_cast<size_t>(
+        ((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> 32) &
+        (capacity - 1));
+  }
+
+  File::Mapping mapping;
+  const char *  data     = nullptr;
+  size_t        dataSize = 0;
+  const Slot *  slots    = nullptr;
+  uint64_t      capacity = 0;
+  uint64_t      count    = 0;
+};
+
+/**
+ * @brief Collects keys and payloads and writes them as a HashIndex file
+ *
+ */
+class HashIndexBuilder {
+public:
+  Result add(const char * key, size_t keyLength, const char * payload,
+      size_t length);
+
+  /**
+   * @brief Add a key and its payload, replacing the payload of an equal key
+   *
+   * @param key to add
+   * @param payload of the key
+   * @return Result INVALID_PARAMETER if the key or payload is 4 GB or longer
+   */
+  inline Result add(const std::string & key, const std::string & payload) {
+    return add(key.c_str(), key.length(), payload.c_str(), payload.length());
+  }
+
+  void   build(std::string & image) const;
+  Result write(const std::string & path) const;
+
+  /**
+   * @brief Get the number of keys added, including replaced keys
+   *
+   * @return size_t count
+   */
+  inline size_t size() const {
+    return entries.size();
+  }
+
+private:
+  /**
+   * @brief Key and payload
+   */
+  struct Entry {
+    HashValue_t hash;
+    std::string key;
+    std::string payload;
+  };
+
+  std::vector<Entry> entries;
+};
+
+#endif /* _FB_HASH_INDEX_H_ */
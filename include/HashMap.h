@@ -0,0 +1,478 @@
+#ifndef _FB_HASH_MAP_H_
+#define _FB_HASH_MAP_H_
+
+#include "Hash.h"
+#include "Result.h"
+
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Flat open addressing map from strings to values
+ * Robin Hood probing over an array of slots holding the 32-bit hash (same as
+ * Hash), probe distance and index of each entry. The entries themselves are
+ * kept densely in insertion order. Probing reads only the slots and compares
+ * hashes before strings, an entry is only touched on a matching hash. Probing
+ * and growing move slots, never entries. Keys are either a Hash or a
+ * character array, both hashed on the fly with Jenkins so a seeded Hash finds
+ * the same entry as its string.
+ *
+ * Header only as the entries are sized by the value type. Pointers to values
+ * are invalidated by set and remove.
+ *
+ * @tparam T type of the values
+ */
+template <typename T>
+class HashMap {
+public:
+  /**
+   * @brief Construct a new empty Hash Map object, allocates on first set
+   */
+  HashMap() {}
+
+  /**
+   * @brief Move constructor
+   * Take the storage from the other map, leaving it empty
+   *
+   * @param map to move
+   */
+  HashMap(HashMap && map) noexcept :
+    slots(map.slots), capacity(map.capacity),
+    entries(std::move(map.entries)) {
+    map.slots    = nullptr;
+    map.capacity = 0;
+    map.entries.clear();
+  }
+
+  /**
+   * @brief Move assignment operator
+   * Swap the storage with the other map, which releases it when destroyed
+   *
+   * @param map to move
+   * @return HashMap&
+   */
+  HashMap & operator=(HashMap && map) noexcept {
+    std::swap(slots, map.slots);
+    std::swap(capacity, map.capacity);
+    entries.swap(map.entries);
+    return *this;
+  }
+
+  HashMap(const HashMap & map) = delete;
+  HashMap & operator=(const HashMap & map) = delete;
+
+  /**
+   * @brief Destroy the Hash Map object
+   * Release the slots, the entries release themselves
+   */
+  ~HashMap() {
+    delete[] slots;
+  }
+
+  /**
+   * @brief Set the value of a key, inserting it if not present
+   *
+   * @param key to set
+   * @param value to copy
+   * @return T& value stored in the map
+   */
+  inline T & set(const Hash & key, const T & value) {
+    return set(key.getString(), value);
+  }
+
+  /**
+   * @brief Set the value of a key, inserting it if not present
+   *
+   * @param key to set
+   * @param length number of characters
+   * @param value to copy
+   * @return T& value stored in the map
+   */
+  inline T & set(const char * key, size_t length, const T & value) {
+    return set(Jenkins::calculate(key, length), key, length, value);
+  }
+
+  /**
+   * @brief Set the value of a key, inserting it if not present
+   *
+   * @param key to set
+   * @param value to copy
+   * @return T& value stored in the map
+   */
+  inline T & set(const std::string & key, const T & value) {
+    return set(key.c_str(), key.length(), value);
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @return T* value or nullptr if the key is not present
+   */
+  inline T * find(const Hash & key) {
+    return find(key.getString());
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @param length number of characters
+   * @return T* value or nullptr if the key is not present
+   */
+  inline T * find(const char * key, size_t length) {
+    return find(Jenkins::calculate(key, length), key, length);
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @return T* value or nullptr if the key is not present
+   */
+  inline T * find(const std::string & key) {
+    return find(key.c_str(), key.length());
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @return const T* value or nullptr if the key is not present
+   */
+  inline const T * find(const Hash & key) const {
+    return const_cast<HashMap *>(this)->find(key);
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @param length number of characters
+   * @return const T* value or nullptr if the key is not present
+   */
+  inline const T * find(const char * key, size_t length) const {
+    return const_cast<HashMap *>(this)->find(key, length);
+  }
+
+  /**
+   * @brief Find the value of a key
+   *
+   * @param key to find
+   * @return const T* value or nullptr if the key is not present
+   */
+  inline const T * find(const std::string & key) const {
+    return const_cast<HashMap *>(this)->find(key);
+  }
+
+  /**
+   * @brief Remove a key and its value
+   *
+   * @param key to remove
+   * @return Result UNKNOWN_HASH if the key is not present
+   */
+  inline Result remove(const Hash & key) {
+    return remove(key.getString());
+  }
+
+  /**
+   * @brief Remove a key and its value
+   *
+   * @param key to remove
+   * @param length number of characters
+   * @return Result UNKNOWN_HASH if the key is not present
+   */
+  inline Result remove(const char * key, size_t length) {
+    return remove(Jenkins::calculate(key, length), key, length);
+  }
+
+  /**
+   * @brief Remove a key and its value
+   *
+   * @param key to remove
+   * @return Result UNKNOWN_HASH if the key is not present
+   */
+  inline Result remove(const std::string & key) {
+    return remove(key.c_str(), key.length());
+  }
+
+  /**
+   * @brief Call a function on every key and value, in insertion order unless
+   * keys have been removed
+   *
+   * @tparam Function callable as function(const std::string &, T &)
+   * @param function to call
+   */
+  template <class Function>
+  void forEach(Function function) {
+    for (Entry & entry : entries)
+      function(entry.key, entry.value);
+  }
+
+  /**
+   * @brief Remove every entry, keeping the storage
+   */
+  void clear() {
+    entries.clear();
+    for (size_t i = 0; i < capacity; ++i)
+      slots[i].distance = 0;
+  }
+
+  /**
+   * @brief Grow the storage to hold a number of entries without growing again
+   *
+   * @param n number of entries to hold
+   */
+  void reserve(size_t n) {
+    size_t newCapacity = capacity == 0 ? MIN_CAPACITY : capacity;
+    while (n * LOAD_DENOMINATOR > newCapacity * LOAD_NUMERATOR)
+      newCapacity *= 2;
+    if (newCapacity != capacity)
+      rehash(newCapacity);
+    entries.reserve(n);
+  }
+
+  /**
+   * @brief Get the number of entries
+   *
+   * @return size_t count
+   */
+  inline size_t size() const {
+    return entries.size();
+  }
+
+  /**
+   * @brief Get the number of slots, entries are held up to a 7/8 load
+   *
+   * @return size_t capacity
+   */
+  inline size_t getCapacity() const {
+    return capacity;
+  }
+
+  /**
+   * @brief Get the number of bytes of storage, excluding the characters of
+   * keys too long for std::string to hold inline
+   *
+   * @return size_t bytes
+   */
+  inline size_t getMemoryUsage() const {
+    return sizeof(HashMap) + capacity * sizeof(Slot) +
+           entries.capacity() * sizeof(Entry);
+  }
+
+private:
+  /**
+   * @brief Probe metadata of an entry
+   * distance is 1 for an entry in its home slot, 0 for an empty slot
+   */
+  struct Slot {
+    HashValue_t hash;
+    uint32_t    distance;
+    uint32_t    index;
+  };
+
+  /**
+   * @brief Key and value
+   */
+  struct Entry {
+    std::string key;
+    T           value;
+  };
+
+  static constexpr size_t MIN_CAPACITY     = 16;
+  static constexpr size_t LOAD_NUMERATOR   = 7;
+  static constexpr size_t LOAD_DENOMINATOR = 8;
+
+  /**
+   * @brief Get the home slot of a hash
+   * Multiplies by 2^64 / golden ratio (Fibonacci hashing) so keys whose hashes
+   * differ only in high bits still spread over a small table
+   *
+   * @param hash of the key
+   * @return size_t slot
+   */
+  inline size_t home(HashValue_t hash) const {
+    return static_cast<size_t>(
+               (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> 32) &
+           (capacity - 1);
+  }
+
+  /**
+   * @brief Find the slot of a key
+   * Stops at an empty slot or an entry closer to its home than the key would
+   * be, as Robin Hood insertion would have placed the key before it
+   *
+   * @param hash of the key
+   * @param key to find
+   * @param length number of characters
+   * @return size_t slot or capacity if the key is not present
+   */
+  size_t findSlot(HashValue_t hash, const char * key, size_t length) const {
+    if (capacity == 0)
+      return capacity;
+    size_t   mask     = capacity - 1;
+    size_t   i        = home(hash);
+    uint32_t distance = 1;
+    while (slots[i].distance >= distance) {
+      if (slots[i].hash == hash) {
+        const std::string & candidate = entries[slots[i].index].key;
+        if (candidate.length() == length &&
+            memcmp(candidate.data(), key, length) == 0)
+          return i;
+      }
+      i = (i + 1) & mask;
+      ++distance;
+    }
+    return capacity;
+  }
+
+  /**
+   * @brief Find the value of a hashed key
+   *
+   * @param hash of the key
+   * @param key to find
+   * @param length number of characters
+   * @return T* value or nullptr if the key is not present
+   */
+  T * find(HashValue_t hash, const char * key, size_t length) {
+    size_t i = findSlot(hash, key, length);
+    return i == capacity ? nullptr : &entries[slots[i].index].value;
+  }
+
+  /**
+   * @brief Set the value of a hashed key, inserting it if not present
+   *
+   * @param hash of the key
+   * @param key to set
+   * @param length number of characters
+   * @param value to copy
+   * @return T& value stored in the map
+   */
+  T & set(HashValue_t hash, const char * key, size_t length, const T & value) {
+    size_t i = findSlot(hash, key, length);
+    if (i != capacity) {
+      T & existing = entries[slots[i].index].value;
+      existing     = value;
+      return existing;
+    }
+    if ((entries.size() + 1) * LOAD_DENOMINATOR > capacity * LOAD_NUMERATOR)
+      rehash(capacity == 0 ? MIN_CAPACITY : capacity * 2);
+    Slot slot = {hash, 1, static_cast<uint32_t>(entries.size())};
+    entries.push_back(Entry{std::string(key, length), value});
+    insert(slot);
+    return entries.back().value;
+  }
+
+  /**
+   * @brief Insert the slot of an entry known not to be present
+   * Robin Hood: a slot further from its home takes the place of one closer
+   * to its home, which continues probing
+   *
+   * @param slot to insert, distance 1
+   */
+  void insert(Slot slot) {
+    size_t mask = capacity - 1;
+    size_t i    = home(slot.hash);
+    while (slots[i].distance != 0) {
+      if (slots[i].distance < slot.distance)
+        std::swap(slot, slots[i]);
+      i = (i + 1) & mask;
+      ++slot.distance;
+    }
+    slots[i] = slot;
+  }
+
+  /**
+   * @brief Find the slot referring to an entry
+   * The entry's hash is only stored in its slot, so it is calculated again
+   * from the key to follow its probe sequence
+   *
+   * @param index of the entry, present
+   * @return size_t slot
+   */
+  size_t findIndex(uint32_t index) const {
+    const std::string & key  = entries[index].key;
+    size_t              mask = capacity - 1;
+    size_t              i =
+        home(Jenkins::calculate(key.c_str(), key.length()));
+    while (slots[i].distance == 0 || slots[i].index != index)
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  /**
+   * @brief Remove a hashed key and its value
+   * Shifts the following slots back until one is in its home slot, so no
+   * tombstones are needed. The last entry moves into the removed entry's
+   * place to keep the entries dense.
+   *
+   * @param hash of the key
+   * @param key to remove
+   * @param length number of characters
+   * @return Result UNKNOWN_HASH if the key is not present
+   */
+  Result remove(HashValue_t hash, const char * key, size_t length) {
+    size_t i = findSlot(hash, key, length);
+    if (i == capacity)
+      return ResultCode_t::UNKNOWN_HASH;
+    uint32_t index = slots[i].index;
+    size_t   mask  = capacity - 1;
+    size_t   next  = (i + 1) & mask;
+    while (slots[next].distance > 1) {
+      slots[i] = slots[next];
+      --slots[i].distance;
+      i    = next;
+      next = (next + 1) & mask;
+    }
+    slots[i].distance = 0;
+
+    uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+    if (index != last) {
+      slots[findIndex(last)].index = index;
+      entries[index]               = std::move(entries[last]);
+    }
+    entries.pop_back();
+    return ResultCode_t::SUCCESS;
+  }
+
+  /**
+   * @brief Move every slot to a new array, entries stay in place
+   *
+   * @param newCapacity number of slots, a power of 2
+   */
+  void rehash(size_t newCapacity) {
+    Slot * oldSlots    = slots;
+    size_t oldCapacity = capacity;
+
+    slots    = new Slot[newCapacity];
+    capacity = newCapacity;
+    for (size_t i = 0; i < capacity; ++i)
+      slots[i].distance = 0;
+
+    for (size_t i = 0; i < oldCapacity; ++i) {
+      if (oldSlots[i].distance != 0) {
+        Slot slot     = oldSlots[i];
+        slot.distance = 1;
+        insert(slot);
+      }
+    }
+    delete[] oldSlots;
+  }
+
+  Slot *             slots    = nullptr;
+  size_t             capacity = 0;
+  std::vector<Entry> entries;
+};
+
+template <typename T>
+constexpr size_t HashMap<T>::MIN_CAPACITY;
+template <typename T>
+constexpr size_t HashMap<T>::LOAD_NUMERATOR;
+template <typename T>
+constexpr size_t HashMap<T>::LOAD_DENOMINATOR;
+
+#endif /* _FB_HASH_MAP_H_ */
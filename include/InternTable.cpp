@@ -0,0 +1,316 @@
+#include "InternTable.h"
+
+#include <cstring>
+#include <new>
+
+/**
+ * @brief Number of entries allocated at a time for a shard's arena
+ */
+static const size_t BLOCK_ENTRIES = 256;
+
+/**
+ * @brief Number of slots of a shard's first table
+ */
+static const size_t MIN_SLOTS = 64;
+
+#ifdef FRUIT_BOWL_NO_THREADS
+/**
+ * @brief Load a pointer shared with lock free readers
+ *
+ * @param link to load
+ * @return T* pointer
+ */
+template <typename T>
+static inline T * load(T * const & link) {
+  return link;
+}
+
+/**
+ * @brief Publish a pointer to lock free readers
+ *
+ * @param link to store to
+ * @param value pointer to store
+ */
+template <typename T>
+static inline void store(T *& link, T * value) {
+  link = value;
+}
+#else
+/**
+ * @brief Load a pointer shared with lock free readers
+ * Acquires the contents of what it points to
+ *
+ * @param link to load
+ * @return T* pointer
+ */
+template <typename T>
+static inline T * load(const std::atomic<T *> & link) {
+  return link.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Publish a pointer to lock free readers
+ * Releases the contents of what it points to, which must be complete
+ *
+ * @param link to store to
+ * @param value pointer to store
+ */
+template <typename T>
+static inline void store(std::atomic<T *> & link, T * value) {
+  link.store(value, std::memory_order_release);
+}
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Construct a new Intern Table object, allocates on first intern
+ */
+InternTable::InternTable() {}
+
+/**
+ * @brief Destroy the Intern Table object
+ * Hashes referencing its strings must be destroyed first
+ */
+InternTable::~InternTable() {
+  for (Shard & shard : shards) {
+    Table * table = load(shard.table);
+    if (table != nullptr) {
+      for (size_t i = 0; i <= table->mask; ++i) {
+        Entry * entry = load(table->slots[i]);
+        if (entry != nullptr)
+          entry->~Entry();
+      }
+      shard.retired.push_back(table);
+    }
+    for (Table * retired : shard.retired) {
+      delete[] retired->slots;
+      delete retired;
+    }
+    for (char * block : shard.blocks)
+      delete[] block;
+  }
+}
+
+/**
+ * @brief Get the process wide table
+ * Never destroyed so hashes in static objects may reference it
+ *
+ * @return InternTable&
+ */
+InternTable & InternTable::getGlobal() {
+  static InternTable * global = new InternTable;
+  return *global;
+}
+
+/**
+ * @brief Intern a character array
+ *
+ * @param c array to intern
+ * @param length number of characters
+ * @return Hash referencing the canonical copy
+ */
+Hash InternTable::intern(const char * c, size_t length) {
+  Jenkins::State_t state;
+  Jenkins::init(state, Jenkins::SEED);
+  Jenkins::update(state, c, length);
+  HashValue_t hash  = Jenkins::finish(state);
+  Shard &     shard = shards[getShardIndex(hash)];
+  Entry *     entry = findEntry(shard, hash, c, length);
+  if (entry == nullptr)
+    entry = insertEntry(shard, hash, state, c, length);
+  return Hash(entry->state, &entry->string);
+}
+
+/**
+ * @brief Intern the string of a hash
+ * The value is recalculated from the string, a seeded or moved from hash has
+ * another value and would otherwise intern a second copy
+ *
+ * @param hash to intern
+ * @return Hash referencing the canonical copy
+ */
+Hash InternTable::intern(const Hash & hash) {
+  const std::string & string = hash.getString();
+  return intern(string.c_str(), string.length());
+}
+
+/**
+ * @brief Find an interned character array without interning it
+ *
+ * @param c array to find
+ * @param length number of characters
+ * @param interned output hash referencing the canonical copy
+ * @return Result UNKNOWN_HASH if the array is not interned
+ */
+Result InternTable::find(
+    const char * c, size_t length, Hash & interned) const {
+  HashValue_t   hash  = Jenkins::calculate(c, length);
+  const Entry * entry = findEntry(shards[getShardIndex(hash)], hash, c, length);
+  if (entry == nullptr)
+    return ResultCode_t::UNKNOWN_HASH;
+  interned = Hash(entry->state, &entry->string);
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Find an interned string by its hash
+ * If several interned strings share the hash, one of them is found
+ *
+ * @param hash to find
+ * @param interned output hash referencing the canonical copy
+ * @return Result UNKNOWN_HASH if no interned string has the hash
+ */
+Result InternTable::find(HashValue_t hash, Hash & interned) const {
+  const Table * table = load(shards[getShardIndex(hash)].table);
+  if (table == nullptr)
+    return ResultCode_t::UNKNOWN_HASH;
+  for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+    const Entry * entry = load(table->slots[i]);
+    if (entry == nullptr)
+      return ResultCode_t::UNKNOWN_HASH;
+    if (entry->hash == hash) {
+      interned = Hash(entry->state, &entry->string);
+      return ResultCode_t::SUCCESS;
+    }
+  }
+}
+
+/**
+ * @brief Get the number of interned strings
+ *
+ * @return size_t count
+ */
+size_t InternTable::size() const {
+  size_t count = 0;
+  for (const Shard & shard : shards) {
+#ifndef FRUIT_BOWL_NO_THREADS
+    std::lock_guard<std::mutex> lock(shard.mutex);
+#endif /* FRUIT_BOWL_NO_THREADS */
+    count += shard.count;
+  }
+  return count;
+}
+
+/**
+ * @brief Get the number of bytes of storage, including retired tables and
+ * the characters of strings too long for std::string to hold inline
+ *
+ * @return size_t bytes
+ */
+size_t InternTable::getMemoryUsage() const {
+  size_t bytes = sizeof(InternTable);
+  for (const Shard & shard : shards) {
+#ifndef FRUIT_BOWL_NO_THREADS
+    std::lock_guard<std::mutex> lock(shard.mutex);
+#endif /* FRUIT_BOWL_NO_THREADS */
+    bytes += shard.blocks.size() * BLOCK_ENTRIES * sizeof(Entry);
+    for (const Table * retired : shard.retired)
+      bytes += sizeof(Table) + (retired->mask + 1) * sizeof(EntryLink_t);
+    const Table * table = load(shard.table);
+    if (table == nullptr)
+      continue;
+    bytes += sizeof(Table) + (table->mask + 1) * sizeof(EntryLink_t);
+    for (size_t i = 0; i <= table->mask; ++i) {
+      const Entry * entry = load(table->slots[i]);
+      if (entry == nullptr)
+        continue;
+      const char * data   = entry->string.data();
+      const char * object = reinterpret_cast<const char *>(&entry->string);
+      if (data < object || data >= object + sizeof(std::string))
+        bytes += entry->string.capacity() + 1;
+    }
+  }
+  return bytes;
+}
+
+/**
+ * @brief Find the entry of a string in a shard, lock free
+ *
+ * @param shard to search
+ * @param hash of the string
+ * @param c array to find
+ * @param length number of characters
+ * @return Entry* canonical copy or nullptr if not interned
+ */
+InternTable::Entry * InternTable::findEntry(
+    const Shard & shard, HashValue_t hash, const char * c, size_t length) {
+  const Table * table = load(shard.table);
+  if (table == nullptr)
+    return nullptr;
+  for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+    Entry * entry = load(table->slots[i]);
+    if (entry == nullptr)
+      return nullptr;
+    if (entry->hash == hash && entry->string.length() == length &&
+        memcmp(entry->string.data(), c, length) == 0)
+      return entry;
+  }
+}
+
+/**
+ * @brief Insert the entry of a string into a shard
+ * Searches again under the lock as another thread may have inserted it
+ *
+ * @param shard to insert into
+ * @param hash of the string
+ * @param state of the hash before finishing
+ * @param c array to insert
+ * @param length number of characters
+ * @return Entry* canonical copy
+ */
+InternTable::Entry * InternTable::insertEntry(Shard & shard, HashValue_t hash,
+    Jenkins::State_t state, const char * c, size_t length) {
+#ifndef FRUIT_BOWL_NO_THREADS
+  std::lock_guard<std::mutex> lock(shard.mutex);
+#endif /* FRUIT_BOWL_NO_THREADS */
+  Entry * entry = findEntry(shard, hash, c, length);
+  if (entry != nullptr)
+    return entry;
+
+  Table * table = load(shard.table);
+  if (table == nullptr || (shard.count + 1) * 2 > table->mask + 1)
+    table = grow(shard, table);
+
+  if (shard.blocks.empty() || shard.blockUsed == BLOCK_ENTRIES) {
+    shard.blocks.push_back(new char[BLOCK_ENTRIES * sizeof(Entry)]);
+    shard.blockUsed = 0;
+  }
+  void * memory = shard.blocks.back() + shard.blockUsed * sizeof(Entry);
+  ++shard.blockUsed;
+  entry = new (memory) Entry{hash, state, std::string(c, length)};
+
+  size_t i = hash & table->mask;
+  while (load(table->slots[i]) != nullptr)
+    i = (i + 1) & table->mask;
+  store(table->slots[i], entry);
+  ++shard.count;
+  return entry;
+}
+
+/**
+ * @brief Replace a shard's table with one twice as large
+ * The old table is retired, lock free readers may still be probing it
+ *
+ * @param shard to grow
+ * @param table current table, nullptr if none
+ * @return Table* new table
+ */
+InternTable::Table * InternTable::grow(Shard & shard, Table * table) {
+  size_t  slots = table == nullptr ? MIN_SLOTS : (table->mask + 1) * 2;
+  Table * grown = new Table;
+  grown->mask   = slots - 1;
+  grown->slots  = new EntryLink_t[slots]();
+  if (table != nullptr) {
+    for (size_t i = 0; i <= table->mask; ++i) {
+      Entry * entry = load(table->slots[i]);
+      if (entry == nullptr)
+        continue;
+      size_t j = entry->hash & grown->mask;
+      while (load(grown->slots[j]) != nullptr)
+        j = (j + 1) & grown->mask;
+      store(grown->slots[j], entry);
+    }
+    shard.retired.push_back(table);
+  }
+  store(shard.table, grown);
+  return grown;
+}
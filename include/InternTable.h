@@ -0,0 +1,128 @@
+#ifndef _FB_INTERN_TABLE_H_
+#define _FB_INTERN_TABLE_H_
+
+#include "Hash.h"
+#include "Result.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef FRUIT_BOWL_NO_THREADS
+#include <atomic>
+#include <mutex>
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Table of interned strings, one canonical immutable copy of each
+ * distinct string along with its hash
+ * Interning returns a Hash referencing the canonical copy instead of owning
+ * one, so an identifier used in many places is stored once and interned
+ * hashes are equal if and only if &getString() are equal.
+ *
+ * The table is split into shards by hash. Lookups are lock free, inserts lock
+ * only their shard. Entries are allocated from a per shard arena and live as
+ * long as the table, the global table is never destroyed. Define
+ * FRUIT_BOWL_NO_THREADS for single threaded programs to drop the atomics and
+ * locks.
+ *
+ */
+class InternTable {
+public:
+  InternTable();
+  ~InternTable();
+
+  InternTable(const InternTable & table) = delete;
+  InternTable & operator=(const InternTable & table) = delete;
+
+  static InternTable & getGlobal();
+
+  Hash intern(const char * c, size_t length);
+  Hash intern(const Hash & hash);
+
+  /**
+   * @brief Intern a string
+   *
+   * @param str to intern
+   * @return Hash referencing the canonical copy
+   */
+  inline Hash intern(const std::string & str) {
+    return intern(str.c_str(), str.length());
+  }
+
+  Result find(const char * c, size_t length, Hash & interned) const;
+  Result find(HashValue_t hash, Hash & interned) const;
+
+  size_t size() const;
+  size_t getMemoryUsage() const;
+
+private:
+  /**
+   * @brief Canonical copy of a string
+   * state is the running hash before finishing, to continue adding to it
+   */
+  struct Entry {
+    HashValue_t      hash;
+    Jenkins::State_t state;
+    std::string      string;
+  };
+
+#ifdef FRUIT_BOWL_NO_THREADS
+  typedef Entry * EntryLink_t;
+#else
+  typedef std::atomic<Entry *> EntryLink_t;
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+  /**
+   * @brief Open addressing array of entries, at most half full
+   * Replaced by a larger table when growing, readers may still be probing the
+   * old one so it is retired rather than deleted
+   */
+  struct Table {
+    size_t        mask;
+    EntryLink_t * slots;
+  };
+
+#ifdef FRUIT_BOWL_NO_THREADS
+  typedef Table * TableLink_t;
+#else
+  typedef std::atomic<Table *> TableLink_t;
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+  /**
+   * @brief Part of the table holding the strings with a range of hashes
+   */
+  struct Shard {
+    TableLink_t          table{nullptr};
+    size_t               count = 0;
+    std::vector<Table *> retired;
+    std::vector<char *>  blocks;
+    size_t               blockUsed = 0;
+#ifndef FRUIT_BOWL_NO_THREADS
+    mutable std::mutex mutex;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  };
+
+  static const size_t SHARD_BITS = 6;
+  static const size_t SHARDS     = 1 << SHARD_BITS;
+
+  static Entry * findEntry(const Shard & shard, HashValue_t hash,
+      const char * c, size_t length);
+  static Entry * insertEntry(Shard & shard, HashValue_t hash,
+      Jenkins::State_t state, const char * c, size_t length);
+  static Table * grow(Shard & shard, Table * table);
+
+  /**
+   * @brief Get the shard of a hash, the top bits as the slots use the bottom
+   *
+   * @param hash of the string
+   * @return size_t index of the shard
+   */
+  static inline size_t getShardIndex(HashValue_t hash) {
+    return hash >> (32 - SHARD_BITS);
+  }
+
+  Shard shards[SHARDS];
+};
+
+#endif /* _FB_INTERN_TABLE_H_ */
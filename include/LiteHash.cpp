@@ -0,0 +1,39 @@
+#include "LiteHash.h"
+
+#include <cstring>
+
+/**
+ * @brief Add a character array until the termination character or length number
+ * of characters
+ *
+ * @param c array to add
+ * @param end character will stop and not hash this character
+ * @return size_t number of characters read
+ */
+template <class Algorithm>
+size_t BasicLiteHash<Algorithm>::add(
+    const char * c, size_t length, const char end) {
+  const void * found = memchr(c, end, length);
+  if (found != nullptr)
+    length = static_cast<size_t>(static_cast<const char *>(found) - c);
+  add(c, length);
+  return length;
+}
+
+/**
+ * @brief Add a character array until the termination character or length number
+ * of characters
+ *
+ * @param c array to add
+ * @param end character will stop and not hash this character
+ * @return size_t number of characters read
+ */
+template <class Algorithm>
+size_t BasicLiteHash<Algorithm>::add(
+    const unsigned char * c, size_t length, const char end) {
+  return add(reinterpret_cast<const char *>(c), length, end);
+}
+
+template class BasicLiteHash<Jenkins>;
+template class BasicLiteHash<XXH64>;
+template class BasicLiteHash<WyHash>;
@@ -0,0 +1,104 @@
+#ifndef _FB_LITE_HASH_H_
+#define _FB_LITE_HASH_H_
+
+#include "HashAlgorithm.h"
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief Hash that only keeps the running hash value
+ * Produces the same values as BasicHash of the same algorithm but does not
+ * keep a copy of the hashed characters, never allocates and is trivially
+ * copyable. Use when only get() is needed, such as lookup keys.
+ *
+ * @tparam Algorithm to calculate the hash with
+ */
+template <class Algorithm>
+class BasicLiteHash {
+public:
+  typedef typename Algorithm::Value_t Value_t;
+  typedef typename Algorithm::Seed_t  Seed_t;
+
+  /**
+   * @brief Construct a new Lite Hash object
+   *
+   * @param seed to initialize the hash to
+   */
+  BasicLiteHash(Seed_t seed = Algorithm::SEED) {
+    Algorithm::init(state, seed);
+  }
+
+  /**
+   * @brief Add a character to the hash
+   *
+   * @param c to add
+   */
+  inline void add(const char c) {
+    Algorithm::update(state, &c, 1);
+  }
+
+  /**
+   * @brief Add a character array, length characters long
+   *
+   * @param c array to add
+   * @param length number of characters
+   */
+  inline void add(const char * c, size_t length) {
+    Algorithm::update(state, c, length);
+  }
+
+  size_t add(const char * c, size_t length, const char end);
+  size_t add(const unsigned char * c, size_t length, const char end);
+
+  /**
+   * @brief Add a string to the hash
+   *
+   * @param str to hash
+   */
+  inline void add(const std::string & str) {
+    add(str.c_str(), str.length());
+  }
+
+  /**
+   * @brief Get the current hash value
+   *
+   * @return const Value_t hash
+   */
+  inline const Value_t get() const {
+    return Algorithm::finish(state);
+  }
+
+  /**
+   * @brief Get the completion status of hashing
+   *
+   * @return true if hashing is complete
+   * @return false if hashing is not complete
+   */
+  inline const bool isDone() const {
+    return hashingDone;
+  }
+
+  /**
+   * @brief Set the completion status of hashing
+   *
+   * @param done if true will indicate hashing is complete
+   */
+  inline void setDone(const bool done) {
+    hashingDone = done;
+  }
+
+private:
+  typename Algorithm::State_t state;
+  bool                        hashingDone = false;
+};
+
+typedef BasicLiteHash<Jenkins> LiteHash;
+typedef BasicLiteHash<XXH64>   LiteHashXXH64;
+typedef BasicLiteHash<WyHash>  LiteHashWy;
+
+extern template class BasicLiteHash<Jenkins>;
+extern template class BasicLiteHash<XXH64>;
+extern template class BasicLiteHash<WyHash>;
+
+#endif /* _FB_LITE_HASH_H_ */
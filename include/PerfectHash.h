@@ -0,0 +1,236 @@
+#ifndef _FB_PERFECT_HASH_H_
+#define _FB_PERFECT_HASH_H_
+
+#include "Hash.h"
+#include "Result.h"
+
+#include <cstring>
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief Minimal perfect hash table of a fixed set of keys
+ * Built at compile time when declared constexpr, no heap and no runtime
+ * construction. Each key is hashed with Jenkins (same as Hash) and placed in
+ * one of N slots by a displacement chosen per bucket (hash and displace).
+ * Lookup is one hash, one slot and one verification compare.
+ *
+ * Header only as the table is sized by the key count. Construction marks the
+ * table invalid if the keys contain duplicates, check with
+ * static_assert(table.isValid(), "...").
+ *
+ * @tparam N number of keys
+ */
+template <size_t N>
+class PerfectHash {
+public:
+  static_assert(N > 0, "PerfectHash requires at least one key");
+
+  /**
+   * @brief Construct a new Perfect Hash object
+   *
+   * @param list of null terminated keys, the index of each is returned by find
+   */
+  constexpr PerfectHash(const char * const (&list)[N]) :
+    keys(), lengths(), hashes(), indices(), displacements(), valid(false) {
+    size_t      keyLengths[N] = {};
+    HashValue_t keyHashes[N]  = {};
+    size_t      sizes[N]      = {};
+    size_t      maxSize       = 0;
+    for (size_t i = 0; i < N; ++i) {
+      while (list[i][keyLengths[i]] != '\0')
+        ++keyLengths[i];
+      keyHashes[i] = Jenkins::calculate(list[i], keyLengths[i]);
+      size_t size  = ++sizes[keyHashes[i] % N];
+      maxSize      = size > maxSize ? size : maxSize;
+      for (size_t j = 0; j < i; ++j) {
+        if (equal(list[i], keyLengths[i], list[j], keyLengths[j]))
+          return;
+      }
+    }
+
+    // Place the largest buckets first while most slots are free
+    bool   used[N]    = {};
+    size_t members[N] = {};
+    size_t chosen[N]  = {};
+    for (size_t size = maxSize; size > 0; --size) {
+      for (size_t bucket = 0; bucket < N; ++bucket) {
+        if (sizes[bucket] != size)
+          continue;
+        size_t count = 0;
+        for (size_t i = 0; i < N; ++i) {
+          if (keyHashes[i] % N == bucket)
+            members[count++] = i;
+        }
+
+        uint32_t displacement = 0;
+        bool     placed       = false;
+        while (!placed) {
+          if (++displacement > MAX_DISPLACEMENT)
+            return;
+          placed = true;
+          for (size_t k = 0; k < count && placed; ++k) {
+            chosen[k] = slot(keyHashes[members[k]], displacement);
+            placed    = !used[chosen[k]];
+            for (size_t j = 0; j < k && placed; ++j)
+              placed = chosen[j] != chosen[k];
+          }
+        }
+
+        displacements[bucket] = displacement;
+        for (size_t k = 0; k < count; ++k) {
+          size_t i           = members[k];
+          used[chosen[k]]    = true;
+          keys[chosen[k]]    = list[i];
+          lengths[chosen[k]] = keyLengths[i];
+          hashes[chosen[k]]  = keyHashes[i];
+          indices[chosen[k]] = i;
+        }
+      }
+    }
+    valid = true;
+  }
+
+  /**
+   * @brief Find a key
+   *
+   * @param key to find
+   * @param length number of characters
+   * @param index output position of the key in the constructing list
+   * @return Result UNKNOWN_HASH if the key is not in the table
+   */
+  Result find(const char * key, size_t length, size_t & index) const {
+    return find(Jenkins::calculate(key, length), key, length, index);
+  }
+
+  /**
+   * @brief Find a key
+   *
+   * @param key to find
+   * @param index output position of the key in the constructing list
+   * @return Result UNKNOWN_HASH if the key is not in the table
+   */
+  inline Result find(const std::string & key, size_t & index) const {
+    return find(key.c_str(), key.length(), index);
+  }
+
+  /**
+   * @brief Find a key that has already been hashed
+   *
+   * @param hash of the key to find, its string is verified
+   * @param index output position of the key in the constructing list
+   * @return Result UNKNOWN_HASH if the key is not in the table
+   */
+  inline Result find(const Hash & hash, size_t & index) const {
+    const std::string & key = hash.getString();
+    return find(hash.get(), key.c_str(), key.length(), index);
+  }
+
+  /**
+   * @brief Get the validity of the table
+   *
+   * @return true if every key was placed
+   * @return false if the keys contain duplicates
+   */
+  constexpr bool isValid() const {
+    return valid;
+  }
+
+  /**
+   * @brief Get the number of keys
+   *
+   * @return constexpr size_t N
+   */
+  static constexpr size_t size() {
+    return N;
+  }
+
+private:
+  /**
+   * @brief Limit of displacements tried for a bucket before giving up
+   */
+  static constexpr uint32_t MAX_DISPLACEMENT = 1 << 16;
+
+  /**
+   * @brief Find a key by its hash, verifying the characters
+   *
+   * @param hash of the key
+   * @param key to find
+   * @param length number of characters
+   * @param index output position of the key in the constructing list
+   * @return Result UNKNOWN_HASH if the key is not in the table
+   */
+  Result find(HashValue_t hash, const char * key, size_t length,
+      size_t & index) const {
+    size_t s = slot(hash, displacements[hash % N]);
+    if (hashes[s] != hash || lengths[s] != length ||
+        memcmp(keys[s], key, length) != 0)
+      return ResultCode_t::UNKNOWN_HASH;
+    index = indices[s];
+    return ResultCode_t::SUCCESS;
+  }
+
+  /**
+   * @brief Calculate the slot of a hash with a displacement
+   * Mixes the hash with the displacement (MurmurHash3's finalizer) so each
+   * displacement gives an independent placement
+   *
+   * @param hash of the key
+   * @param displacement of the key's bucket
+   * @return constexpr size_t slot
+   */
+  static constexpr size_t slot(HashValue_t hash, uint32_t displacement) {
+    uint32_t x = hash ^ (displacement * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x % N;
+  }
+
+  /**
+   * @brief Compare two character arrays at compile time
+   *
+   * @param a first array
+   * @param aLength number of characters in a
+   * @param b second array
+   * @param bLength number of characters in b
+   * @return true if the arrays are equal
+   */
+  static constexpr bool equal(
+      const char * a, size_t aLength, const char * b, size_t bLength) {
+    if (aLength != bLength)
+      return false;
+    for (size_t i = 0; i < aLength; ++i) {
+      if (a[i] != b[i])
+        return false;
+    }
+    return true;
+  }
+
+  const char * keys[N];
+  size_t       lengths[N];
+  HashValue_t  hashes[N];
+  size_t       indices[N];
+  uint32_t     displacements[N];
+  bool         valid;
+};
+
+template <size_t N>
+constexpr uint32_t PerfectHash<N>::MAX_DISPLACEMENT;
+
+/**
+ * @brief Make a perfect hash table, deducing the number of keys
+ * static constexpr auto TABLE = makePerfectHash({"get", "set"});
+ *
+ * @tparam N number of keys
+ * @param keys null terminated strings
+ * @return constexpr PerfectHash<N> table
+ */
+template <size_t N>
+constexpr PerfectHash<N> makePerfectHash(const char * const (&keys)[N]) {
+  return PerfectHash<N>(keys);
+}
+
+#endif /* _FB_PERFECT_HASH_H_ */
@@ -0,0 +1,74 @@
+#ifndef _FB_REFERENCE_COUNT_H_
+#define _FB_REFERENCE_COUNT_H_
+
+#include <stdint.h>
+
+#ifndef FRUIT_BOWL_NO_THREADS
+#include <atomic>
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Counts the references to memory shared between objects
+ * The counter is atomic such that objects sharing memory can be copied and
+ * destroyed from different threads. Define FRUIT_BOWL_NO_THREADS for single
+ * threaded programs to use a plain integer instead.
+ *
+ */
+class ReferenceCount {
+public:
+  /**
+   * @brief Construct a new Reference Count object
+   *
+   * @param count initial number of references
+   */
+  constexpr ReferenceCount(int32_t count = 1) : count(count) {}
+
+  /**
+   * @brief Add a reference
+   * No ordering is needed, the new reference comes from an existing one
+   */
+  inline void increment() {
+#ifdef FRUIT_BOWL_NO_THREADS
+    ++count;
+#else
+    count.fetch_add(1, std::memory_order_relaxed);
+#endif /* FRUIT_BOWL_NO_THREADS */
+  }
+
+  /**
+   * @brief Remove a reference
+   * Orders all prior uses of the shared memory before its deletion
+   *
+   * @return true if that was the last reference, shared memory can be deleted
+   * @return false if other references remain
+   */
+  inline bool decrement() {
+#ifdef FRUIT_BOWL_NO_THREADS
+    return (--count) <= 0;
+#else
+    return count.fetch_sub(1, std::memory_order_acq_rel) <= 1;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  }
+
+  /**
+   * @brief Get the number of references
+   *
+   * @return int32_t count
+   */
+  inline operator int32_t() const {
+#ifdef FRUIT_BOWL_NO_THREADS
+    return count;
+#else
+    return count.load(std::memory_order_relaxed);
+#endif /* FRUIT_BOWL_NO_THREADS */
+  }
+
+private:
+#ifdef FRUIT_BOWL_NO_THREADS
+  int32_t count;
+#else
+  std::atomic<int32_t> count;
+#endif /* FRUIT_BOWL_NO_THREADS */
+};
+
+#endif /* _FB_REFERENCE_COUNT_H_ */
@@ -1,30 +1,72 @@
 #include "Result.h"
 
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#ifndef FRUIT_BOWL_NO_THREADS
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Reference count reported for results without a message
+ * Code only results do not share any memory so they are always the sole
+ * reference to their (empty) message
+ */
+static const ReferenceCount SOLE_REFERENCE(1);
+
+/**
+ * @brief Separator placed before each appended string
+ */
+static const char   SEPARATOR[]      = "\n  ->";
+static const size_t SEPARATOR_LENGTH = sizeof(SEPARATOR) - 1;
+
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+static inline void addFailure(ResultCode_t code);
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+
 /**
  * @brief Construct a new Result object
- * Create a new referenceCount equal to 1
+ * No memory is allocated until a message is appended, the first frame is
+ * created by operator+
  *
  * @param code to initialize
  */
-Result::Result(ResultCode_t code) : code(code), referenceCount(new int16_t) {
-  *referenceCount = 1;
+Result::Result(ResultCode_t code) : code(code) {
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  if (code != ResultCode_t::SUCCESS)
+    addFailure(code);
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
 }
 
 /**
  * @brief Copy constructor
- * Copy the values and increment referenceCount
+ * Copy the values and increment the frame's referenceCount
  *
  * @param result to copy
  */
-Result::Result(const Result & result) :
-  code(result.code), message(result.message),
-  referenceCount(result.referenceCount) {
-  ++(*referenceCount);
+Result::Result(const Result & result) : code(result.code), frame(result.frame) {
+  if (frame != nullptr)
+    frame->referenceCount.increment();
+}
+
+/**
+ * @brief Move constructor
+ * Take the frame from the other result, leaving it without a message
+ *
+ * @param result to move
+ */
+Result::Result(Result && result) noexcept :
+  code(result.code), frame(result.frame) {
+  result.frame = nullptr;
 }
 
 /**
  * @brief Assignment operator
- * Decrement the left hand side and delete if zero references
+ * Release the left hand side's frame
  * Set the left hand side to the right and increment its counter
  *
  * @param result to assign
@@ -32,34 +74,40 @@ Result::Result(const Result & result) :
  */
 Result & Result::operator=(const Result & result) {
   if (this != &result) {
-    if (referenceCount != nullptr && (--(*referenceCount)) <= 0) {
-      delete referenceCount;
-      delete message;
-    }
-    code           = result.code;
-    message        = result.message;
-    referenceCount = result.referenceCount;
-    ++(*referenceCount);
+    if (result.frame != nullptr)
+      result.frame->referenceCount.increment();
+    releaseFrame(frame);
+    code  = result.code;
+    frame = result.frame;
   }
   return *this;
 }
 
 /**
- * @brief Destroy the Result object
- * Decrement the reference counter and delete the memory if zero references
+ * @brief Move assignment operator
+ * Release the left hand side's frame and take the frame from the right,
+ * leaving it without a message
  *
- * Deletes the message string if present
+ * @param result to move
+ * @return Result&
  */
-Result::~Result() {
-  if (referenceCount != nullptr) {
-    (*referenceCount)--;
-    if (*referenceCount <= 0) {
-      delete referenceCount;
-      delete message;
-      referenceCount = nullptr;
-      message        = nullptr;
-    }
+Result & Result::operator=(Result && result) noexcept {
+  if (this != &result) {
+    releaseFrame(frame);
+    code         = result.code;
+    frame        = result.frame;
+    result.frame = nullptr;
   }
+  return *this;
+}
+
+/**
+ * @brief Destroy the Result object
+ * Release the frame, deleting the chain of frames no longer referenced
+ */
+Result::~Result() {
+  releaseFrame(frame);
+  frame = nullptr;
 }
 
 /**
@@ -73,45 +121,749 @@ ResultCode_t Result::getCode() const {
 
 /**
  * @brief Get the message of the result
+ * The code's message followed by each appended string, oldest first
+ * The message is formatted on the first call and cached in the frame
  *
  * @return const char*
  */
 const char * Result::getMessage() const {
-  if (message == nullptr)
-    return Results::MESSAGES[static_cast<uint8_t>(code)];
+  const char * base = Results::MESSAGES[static_cast<uint8_t>(code)];
+  if (frame == nullptr)
+    return base;
+  char * rendered = frame->rendered;
+  if (rendered != nullptr)
+    return rendered;
+
+  // Deferred frames are formatted first, in chain order
+  std::vector<std::string> formatted;
+  size_t                   baseLength = strlen(base);
+  size_t                   length     = baseLength;
+  for (const Frame * link = frame; link != nullptr; link = link->parent) {
+    if (link->deferred) {
+      formatted.push_back(formatFrame(link));
+      length += SEPARATOR_LENGTH + formatted.back().length();
+    } else {
+      length += SEPARATOR_LENGTH + link->length;
+    }
+  }
+
+  // Fill from the end since the chain is linked newest to oldest
+  rendered   = static_cast<char *>(allocate(length + 1));
+  char * end = rendered + length;
+  *end       = '\0';
+  size_t next = 0;
+  for (const Frame * link = frame; link != nullptr; link = link->parent) {
+    if (link->deferred) {
+      const std::string & text = formatted[next++];
+      end -= text.length();
+      memcpy(end, text.data(), text.length());
+    } else {
+      end -= link->length;
+      memcpy(end, link->text, link->length);
+    }
+    end -= SEPARATOR_LENGTH;
+    memcpy(end, SEPARATOR, SEPARATOR_LENGTH);
+  }
+  memcpy(rendered, base, baseLength);
+
+#ifdef FRUIT_BOWL_NO_THREADS
+  frame->rendered       = rendered;
+  frame->renderedLength = length;
+#else
+  // Another thread may have formatted the shared frame first, keep theirs
+  char * expected = nullptr;
+  if (frame->rendered.compare_exchange_strong(expected, rendered)) {
+    // Only read by releaseFrame, after every reference is released
+    frame->renderedLength = length;
+  } else {
+    deallocate(rendered, length + 1);
+    rendered = expected;
+  }
+#endif /* FRUIT_BOWL_NO_THREADS */
+  return rendered;
+}
+
+/**
+ * @brief Get reference count, number of references to message frame
+ * A result without a message is always the only reference
+ *
+ * @return const ReferenceCount *
+ */
+const ReferenceCount * Result::getReferenceCount() const {
+  if (frame == nullptr)
+    return &SOLE_REFERENCE;
+  return &frame->referenceCount;
+}
+
+/**
+ * @brief Create a new frame holding a copy of text
+ * The frame takes a reference to its parent
+ *
+ * @param parent frame, nullptr if first appended string
+ * @param text to copy into the frame
+ * @return Result::Frame* frame with referenceCount equal to 1
+ */
+Result::Frame * Result::createFrame(Frame * parent, const char * text) {
+  size_t length = strlen(text);
+
+  // Frame::text already has room for the '\0'
+  Frame * frame         = new (allocate(sizeof(Frame) + length)) Frame;
+  frame->deferred       = false;
+  frame->parent         = parent;
+  frame->rendered       = nullptr;
+  frame->renderedLength = 0;
+  frame->length         = length;
+  memcpy(frame->text, text, length + 1);
+
+  if (parent != nullptr)
+    parent->referenceCount.increment();
+  return frame;
+}
+
+/**
+ * @brief Stored start of a deferred frame's text, followed by its arguments
+ * then the characters of its string arguments
+ */
+struct Captured {
+  Result::Location location;
+  const char *     format;
+  size_t           count;
+};
+
+/**
+ * @brief Create a new frame holding a deferred message
+ * Only the arguments are stored, string arguments are copied into the frame
+ * so the caller's strings may be released
+ *
+ * @param parent frame, nullptr if first appended message
+ * @param deferred message to store
+ * @return Result::Frame* frame with referenceCount equal to 1
+ */
+Result::Frame * Result::createFrame(Frame * parent, const Deferred & deferred) {
+  typedef Deferred::Argument Argument;
+  size_t length = sizeof(Captured) + deferred.count * sizeof(Argument);
+  for (size_t i = 0; i < deferred.count; ++i) {
+    if (deferred.arguments[i].type == Argument::Type_t::STRING)
+      length += deferred.arguments[i].length;
+  }
+
+  Frame * frame         = new (allocate(sizeof(Frame) + length)) Frame;
+  frame->deferred       = true;
+  frame->parent         = parent;
+  frame->rendered       = nullptr;
+  frame->renderedLength = 0;
+  frame->length         = length;
+
+  Captured captured = {deferred.location, deferred.format, deferred.count};
+  char *   next     = frame->text;
+  memcpy(next, &captured, sizeof(Captured));
+  next += sizeof(Captured);
+  char * strings = next + deferred.count * sizeof(Argument);
+  for (size_t i = 0; i < deferred.count; ++i) {
+    Argument argument = deferred.arguments[i];
+    if (argument.type == Argument::Type_t::STRING) {
+      memcpy(strings, argument.s, argument.length);
+      argument.s = strings;
+      strings += argument.length;
+    }
+    memcpy(next, &argument, sizeof(Argument));
+    next += sizeof(Argument);
+  }
+
+  if (parent != nullptr)
+    parent->referenceCount.increment();
+  return frame;
+}
+
+/**
+ * @brief Format a deferred frame
+ * Each "{}" is replaced by the next argument, followed by the file name, line
+ * and function
+ *
+ * @param frame to format, deferred
+ * @return std::string message
+ */
+std::string Result::formatFrame(const Frame * frame) {
+  typedef Deferred::Argument Argument;
+  Captured captured;
+  memcpy(&captured, frame->text, sizeof(Captured));
+  const char * arguments = frame->text + sizeof(Captured);
+
+  std::string  message;
+  size_t       used = 0;
+  char         number[32];
+  const char * c = captured.format;
+  while (*c != '\0') {
+    if (c[0] != '{' || c[1] != '}' || used == captured.count) {
+      message += *c++;
+      continue;
+    }
+    c += 2;
+    Argument argument;
+    memcpy(&argument, arguments + used * sizeof(Argument), sizeof(Argument));
+    ++used;
+    switch (argument.type) {
+      case Argument::Type_t::BOOL:
+        message += argument.u != 0 ? "true" : "false";
+        break;
+      case Argument::Type_t::CHAR:
+        message += static_cast<char>(argument.u);
+        break;
+      case Argument::Type_t::SIGNED:
+        snprintf(number, sizeof(number), "%lld",
+            static_cast<long long>(argument.i));
+        message += number;
+        break;
+      case Argument::Type_t::UNSIGNED:
+        snprintf(number, sizeof(number), "%llu",
+            static_cast<unsigned long long>(argument.u));
+        message += number;
+        break;
+      case Argument::Type_t::DOUBLE:
+        snprintf(number, sizeof(number), "%g", argument.d);
+        message += number;
+        break;
+      case Argument::Type_t::STRING:
+        message.append(argument.s, argument.length);
+        break;
+      case Argument::Type_t::POINTER:
+        snprintf(number, sizeof(number), "%p", argument.p);
+        message += number;
+        break;
+    }
+  }
+
+  // Only the file name, paths are long and differ between machines
+  const char * file = captured.location.file;
+  for (const char * p = file; *p != '\0'; ++p) {
+    if (*p == '/' || *p == '\\')
+      file = p + 1;
+  }
+  snprintf(number, sizeof(number), ":%d ", captured.location.line);
+  message += " (";
+  message += file;
+  message += number;
+  message += captured.location.function;
+  message += ")";
   return message;
 }
 
 /**
- * @brief Get reference count, number of references to message string
+ * @brief Release a reference to a frame
+ * Delete the frame if zero references and continue up the chain of parents
+ * Iterative to not recurse on long chains
  *
- * @return int16_t
+ * @param frame to release, may be nullptr
  */
-const int16_t * Result::getReferenceCount() const {
-  return referenceCount;
+void Result::releaseFrame(Frame * frame) {
+  while (frame != nullptr && frame->referenceCount.decrement()) {
+    Frame * parent   = frame->parent;
+    char *  rendered = frame->rendered;
+    if (rendered != nullptr)
+      deallocate(rendered, frame->renderedLength + 1);
+    size_t size = sizeof(Frame) + frame->length;
+    frame->~Frame();
+    deallocate(frame, size);
+    frame = parent;
+  }
 }
 
 /**
  * @brief Addition operator for appending a string
  * Create a new result, set its code and severity to the left hand side
- * Set the new result's message to the left's appended by the right string
+ * Set the new result's frame to the right string, linked to the left's frame
  * Return the new result
  *
  * @param left hand side - a result
  * @param right hand side - a string to append
  * @return Result combined result
  */
-const Result operator+(const Result & left, const char * right) {
-  Result result(left.getCode());
-
-  // 5 for "\n  ->", 1 for '\0'
-  size_t length = strlen(left.getMessage()) + 5 + strlen(right) + 1;
+Result operator+(const Result & left, const char * right) {
+  Result result = Result::forward(left.code);
+  result.frame  = Result::createFrame(left.frame, right);
+  return result;
+}
 
-  result.message = new char[length];
-  snprintf(result.message, length, "%s\n  ->%s", left.getMessage(), right);
+/**
+ * @brief Addition operator for appending a deferred message
+ * Only stores the arguments, formatting waits until the message is requested
+ *
+ * @param left hand side - a result
+ * @param right hand side - a deferred message to append, see FB_FORMAT
+ * @return Result combined result
+ */
+Result operator+(const Result & left, const Result::Deferred & right) {
+  Result result = Result::forward(left.code);
+  result.frame  = Result::createFrame(left.frame, right);
   return result;
 }
 
+/**
+ * @brief Sizes of cached blocks, 64 << class for each class
+ * Larger requests always use the global allocator
+ */
+static const size_t CLASS_COUNT = 5;
+
+/**
+ * @brief Most blocks of each class kept by a thread, the rest are returned to
+ * the global allocator
+ */
+static const uint32_t CACHE_LIMIT = 32;
+
+/**
+ * @brief Get the size class of a request
+ *
+ * @param size number of bytes
+ * @return size_t class, CLASS_COUNT if too large to cache
+ */
+static inline size_t getClass(size_t size) {
+  size_t c = 0;
+  while (c < CLASS_COUNT && size > (static_cast<size_t>(64) << c))
+    ++c;
+  return c;
+}
+
+#ifdef FRUIT_BOWL_NO_THREADS
+typedef int64_t Counter_t;
+
+/**
+ * @brief Add to a counter
+ *
+ * @param counter to add to
+ * @param value to add, may be negative
+ * @return int64_t new value
+ */
+static inline int64_t addCounter(Counter_t & counter, int64_t value) {
+  return counter += value;
+}
+#else
+typedef std::atomic<int64_t> Counter_t;
+
+/**
+ * @brief Add to a counter
+ * Relaxed as the statistics are only a snapshot
+ *
+ * @param counter to add to
+ * @param value to add, may be negative
+ * @return int64_t new value
+ */
+static inline int64_t addCounter(Counter_t & counter, int64_t value) {
+  return counter.fetch_add(value, std::memory_order_relaxed) + value;
+}
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Free blocks of one thread, a list per size class linked through the
+ * first word of each block
+ */
+struct FrameCache {
+  void *    lists[CLASS_COUNT]  = {};
+  uint32_t  counts[CLASS_COUNT] = {};
+  Counter_t inUse{0};
+
+  /**
+   * @brief Return every cached block to the global allocator
+   *
+   * @return size_t number of bytes returned
+   */
+  size_t release() {
+    size_t bytes = 0;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+      while (lists[c] != nullptr) {
+        void * block = lists[c];
+        lists[c]     = *static_cast<void **>(block);
+        ::operator delete(block);
+        bytes += static_cast<size_t>(64) << c;
+      }
+      counts[c] = 0;
+    }
+    return bytes;
+  }
+};
+
+/**
+ * @brief Statistics shared by every thread, only updated when calling the
+ * global allocator
+ */
+struct Totals {
+  Counter_t reserved{0};
+  Counter_t highWater{0};
+  Counter_t retired{0}; // inUse of exited threads and of results released
+                        // after their thread's cache
+#ifndef FRUIT_BOWL_NO_THREADS
+  std::mutex                mutex;
+  std::vector<FrameCache *> caches;
+#endif /* FRUIT_BOWL_NO_THREADS */
+};
+
+/**
+ * @brief Get the shared statistics
+ * Constructed on first use so it outlives every thread's cache
+ *
+ * @return Totals&
+ */
+static Totals & getTotals() {
+  static Totals totals;
+  return totals;
+}
+
+/**
+ * @brief Account for bytes taken from the global allocator
+ *
+ * @param bytes taken, negative when returned
+ */
+static void reserve(int64_t bytes) {
+  Totals & totals   = getTotals();
+  int64_t  reserved = addCounter(totals.reserved, bytes);
+#ifdef FRUIT_BOWL_NO_THREADS
+  if (reserved > totals.highWater)
+    totals.highWater = reserved;
+#else
+  int64_t highWater = totals.highWater.load(std::memory_order_relaxed);
+  while (reserved > highWater &&
+         !totals.highWater.compare_exchange_weak(
+             highWater, reserved, std::memory_order_relaxed))
+    continue;
+#endif /* FRUIT_BOWL_NO_THREADS */
+}
+
+#ifdef FRUIT_BOWL_NO_THREADS
+/**
+ * @brief Get the cache of the program
+ *
+ * @return FrameCache*
+ */
+static FrameCache * getCache() {
+  static FrameCache cache;
+  return &cache;
+}
+#else
+static thread_local FrameCache * currentCache = nullptr;
+static thread_local bool         cacheExited  = false;
+
+/**
+ * @brief Registers a thread's cache for the statistics and releases it when
+ * the thread exits
+ */
+struct CacheOwner {
+  FrameCache cache;
+
+  /**
+   * @brief Construct a new Cache Owner object, registering the cache
+   */
+  CacheOwner() {
+    Totals &                    totals = getTotals();
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    totals.caches.push_back(&cache);
+  }
+
+  /**
+   * @brief Destroy the Cache Owner object
+   * Results released later on this thread use the global allocator
+   */
+  ~CacheOwner() {
+    currentCache    = nullptr;
+    cacheExited     = true;
+    Totals & totals = getTotals();
+    reserve(-static_cast<int64_t>(cache.release()));
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    addCounter(totals.retired, cache.inUse.load(std::memory_order_relaxed));
+    totals.caches.erase(
+        std::find(totals.caches.begin(), totals.caches.end(), &cache));
+  }
+};
+
+/**
+ * @brief Get the cache of the calling thread, created on first use
+ *
+ * @return FrameCache* nullptr once the thread is exiting
+ */
+static FrameCache * getCache() {
+  if (currentCache != nullptr)
+    return currentCache;
+  if (cacheExited)
+    return nullptr;
+  static thread_local CacheOwner owner;
+  currentCache = &owner.cache;
+  return currentCache;
+}
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Allocate memory for a frame or formatted message
+ *
+ * @param size number of bytes
+ * @return void* memory, from the calling thread's cache if possible
+ */
+void * Result::allocate(size_t size) {
+  size_t       c     = getClass(size);
+  FrameCache * cache = nullptr;
+#ifndef FRUIT_BOWL_NO_RESULT_POOL
+  // Blocks are always a whole class so any thread can cache them
+  cache = getCache();
+  if (c < CLASS_COUNT)
+    size = static_cast<size_t>(64) << c;
+#endif /* FRUIT_BOWL_NO_RESULT_POOL */
+  if (c < CLASS_COUNT && cache != nullptr) {
+    addCounter(cache->inUse, static_cast<int64_t>(size));
+    void * block = cache->lists[c];
+    if (block != nullptr) {
+      cache->lists[c] = *static_cast<void **>(block);
+      --cache->counts[c];
+      return block;
+    }
+  } else {
+    addCounter(getTotals().retired, static_cast<int64_t>(size));
+  }
+  reserve(static_cast<int64_t>(size));
+  return ::operator new(size);
+}
+
+/**
+ * @brief Deallocate memory from allocate, on any thread
+ *
+ * @param memory to deallocate
+ * @param size number of bytes, as passed to allocate
+ */
+void Result::deallocate(void * memory, size_t size) {
+  size_t       c     = getClass(size);
+  FrameCache * cache = nullptr;
+#ifndef FRUIT_BOWL_NO_RESULT_POOL
+  cache = getCache();
+  if (c < CLASS_COUNT)
+    size = static_cast<size_t>(64) << c;
+#endif /* FRUIT_BOWL_NO_RESULT_POOL */
+  if (c < CLASS_COUNT && cache != nullptr) {
+    addCounter(cache->inUse, -static_cast<int64_t>(size));
+    if (cache->counts[c] < CACHE_LIMIT) {
+      *static_cast<void **>(memory) = cache->lists[c];
+      cache->lists[c]               = memory;
+      ++cache->counts[c];
+      return;
+    }
+  } else {
+    addCounter(getTotals().retired, -static_cast<int64_t>(size));
+  }
+  reserve(-static_cast<int64_t>(size));
+  ::operator delete(memory);
+}
+
+/**
+ * @brief Get the memory held for messages across every thread
+ * Counters are updated without synchronization so the snapshot may be
+ * slightly out of date
+ *
+ * @return MemoryStatistics
+ */
+Result::MemoryStatistics Result::getMemoryStatistics() {
+  Totals & totals = getTotals();
+#ifdef FRUIT_BOWL_NO_THREADS
+  int64_t inUse = totals.retired + getCache()->inUse;
+  return MemoryStatistics{static_cast<size_t>(inUse),
+      static_cast<size_t>(totals.reserved),
+      static_cast<size_t>(totals.highWater)};
+#else
+  std::lock_guard<std::mutex> lock(totals.mutex);
+  int64_t                     inUse =
+      totals.retired.load(std::memory_order_relaxed);
+  for (const FrameCache * cache : totals.caches)
+    inUse += cache->inUse.load(std::memory_order_relaxed);
+  return MemoryStatistics{static_cast<size_t>(inUse < 0 ? 0 : inUse),
+      static_cast<size_t>(totals.reserved.load(std::memory_order_relaxed)),
+      static_cast<size_t>(totals.highWater.load(std::memory_order_relaxed))};
+#endif /* FRUIT_BOWL_NO_THREADS */
+}
+
+/**
+ * @brief Return the calling thread's cached memory to the global allocator
+ * Call at the end of a request (or error storm) to drop the memory held for
+ * the next. Results still referenced are unaffected.
+ */
+void Result::releaseMemory() {
+  FrameCache * cache = getCache();
+  if (cache != nullptr)
+    reserve(-static_cast<int64_t>(cache->release()));
+}
+
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+#ifdef FRUIT_BOWL_NO_THREADS
+/**
+ * @brief Failures created of each code
+ */
+static uint64_t failureCounts[Results::COUNT] = {};
+
+/**
+ * @brief Count a failure
+ *
+ * @param code of the failure
+ */
+static inline void addFailure(ResultCode_t code) {
+  ++failureCounts[static_cast<size_t>(code)];
+}
+#else
+/**
+ * @brief Failures created of each code by one thread
+ * Only the owning thread writes, so an increment is a relaxed load and store
+ * rather than a locked add. Aligned so no other thread writes the same cache
+ * lines.
+ */
+struct alignas(64) FailureCounters {
+  std::atomic<uint64_t> counts[Results::COUNT];
+
+  /**
+   * @brief Construct a new Failure Counters object
+   */
+  FailureCounters() {
+    for (std::atomic<uint64_t> & count : counts)
+      count.store(0, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Counters of every thread and the failures of exited threads
+ */
+struct FailureTotals {
+  std::atomic<uint64_t>          retired[Results::COUNT];
+  std::mutex                     mutex;
+  std::vector<FailureCounters *> counters;
+
+  /**
+   * @brief Construct a new Failure Totals object
+   */
+  FailureTotals() {
+    for (std::atomic<uint64_t> & count : retired)
+      count.store(0, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Get the counters of every thread
+ * Constructed on first use so it outlives every thread's counters
+ *
+ * @return FailureTotals&
+ */
+static FailureTotals & getFailureTotals() {
+  static FailureTotals totals;
+  return totals;
+}
+
+static thread_local FailureCounters * currentCounters = nullptr;
+static thread_local bool              countersExited  = false;
+
+/**
+ * @brief Registers a thread's counters for the statistics and retires them
+ * when the thread exits
+ */
+struct CountersOwner {
+  FailureCounters counters;
+
+  /**
+   * @brief Construct a new Counters Owner object, registering the counters
+   */
+  CountersOwner() {
+    FailureTotals &             totals = getFailureTotals();
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    totals.counters.push_back(&counters);
+  }
+
+  /**
+   * @brief Destroy the Counters Owner object
+   * Failures created later on this thread are added to the retired counts
+   */
+  ~CountersOwner() {
+    currentCounters = nullptr;
+    countersExited  = true;
+
+    FailureTotals &             totals = getFailureTotals();
+    std::lock_guard<std::mutex> lock(totals.mutex);
+    for (size_t i = 0; i < Results::COUNT; ++i)
+      totals.retired[i].fetch_add(
+          counters.counts[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    totals.counters.erase(std::find(
+        totals.counters.begin(), totals.counters.end(), &counters));
+  }
+};
+
+// Kept out of addFailure so counting needs no stack frame
+#ifdef _MSC_VER
+#define FB_NOINLINE __declspec(noinline)
+#else
+#define FB_NOINLINE __attribute__((noinline))
+#endif
+
+/**
+ * @brief Count a failure of a thread without counters yet, or exiting
+ *
+ * @param code of the failure
+ */
+FB_NOINLINE static void countFirstFailure(ResultCode_t code) {
+  size_t i = static_cast<size_t>(code);
+  if (countersExited) {
+    getFailureTotals().retired[i].fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  static thread_local CountersOwner owner;
+  currentCounters = &owner.counters;
+  currentCounters->counts[i].store(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Count a failure in the calling thread's counters
+ *
+ * @param code of the failure
+ */
+static inline void addFailure(ResultCode_t code) {
+  FailureCounters * counters = currentCounters;
+  if (counters == nullptr) {
+    countFirstFailure(code);
+    return;
+  }
+  std::atomic<uint64_t> & count = counters->counts[static_cast<size_t>(code)];
+  count.store(count.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+}
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Count a new failure of a code held without a Result, such as by an
+ * Expected with a ResultCode_t error
+ *
+ * @param code of the failure
+ */
+void Result::countFailure(ResultCode_t code) {
+  if (code != ResultCode_t::SUCCESS)
+    addFailure(code);
+}
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+
+/**
+ * @brief Get the failures created of each code across every thread
+ * Writers are never stopped so the snapshot may be slightly out of date. Every
+ * count is 0 unless FRUIT_BOWL_RESULT_TELEMETRY is defined.
+ *
+ * @return ErrorStatistics
+ */
+Result::ErrorStatistics Result::getErrorStatistics() {
+  ErrorStatistics statistics;
+  memset(&statistics, 0, sizeof(statistics));
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+#ifdef FRUIT_BOWL_NO_THREADS
+  memcpy(statistics.counts, failureCounts, sizeof(statistics.counts));
+#else
+  FailureTotals &             totals = getFailureTotals();
+  std::lock_guard<std::mutex> lock(totals.mutex);
+  for (size_t i = 0; i < Results::COUNT; ++i)
+    statistics.counts[i] = totals.retired[i].load(std::memory_order_relaxed);
+  for (const FailureCounters * counters : totals.counters)
+    for (size_t i = 0; i < Results::COUNT; ++i)
+      statistics.counts[i] +=
+          counters->counts[i].load(std::memory_order_relaxed);
+#endif /* FRUIT_BOWL_NO_THREADS */
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+  return statistics;
+}
+
 /**
  * @brief Output stream insertion operator
  *
@@ -121,4 +873,20 @@ const Result operator+(const Result & left, const char * right) {
  */
 std::ostream & operator<<(std::ostream & stream, const Result & result) {
   return stream << result.getMessage();
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Output stream insertion operator
+ * Write the count and message of each code with failures, one per line
+ *
+ * @param stream to write to
+ * @param statistics to insert
+ * @return std::ostream& original stream
+ */
+std::ostream & operator<<(
+    std::ostream & stream, const Result::ErrorStatistics & statistics) {
+  for (size_t i = 0; i < Results::COUNT; ++i)
+    if (statistics.counts[i] != 0)
+      stream << statistics.counts[i] << " " << Results::MESSAGES[i] << "\n";
+  return stream;
+}
@@ -1,32 +1,53 @@
 #ifndef _FB_RESULT_H_
 #define _FB_RESULT_H_
 
+#include "ReferenceCount.h"
 #include "ResultCode.h"
 
+#include <cstring>
 #include <iostream>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
 
 /**
  * @brief Holds an error code and message
  * The message is empty (not using memory) until a custom message is set (by
- * appending a string)
+ * appending a string). A code only result never allocates, the reference
+ * counter is only created alongside a custom message.
  *
- * The message is implemented as a shared pointer such that copying a result
- * with a custom message does not copy the string. This makes the return code
- * lightweight, not requiring returning a pointer to a result.
+ * The message is stored as a chain of immutable frames, one per appended
+ * string, shared between copies of a result. Appending only allocates the new
+ * frame so propagating through N calls is linear. The full message is only
+ * formatted when requested by getMessage or operator<<.
+ *
+ * A message may also be deferred, see FB_FORMAT: the format string, typed
+ * arguments and source location are stored in the frame and only formatted
+ * with the rest of the message.
+ *
+ * Frames and formatted messages come from a per thread cache of size classes,
+ * so a storm of errors does not contend on the global allocator. A frame may
+ * be released on any thread, it then joins that thread's cache. Define
+ * FRUIT_BOWL_NO_RESULT_POOL to allocate each one from the global allocator.
+ *
+ * Define FRUIT_BOWL_RESULT_TELEMETRY to count the failures created of each
+ * code, see getErrorStatistics. Copies, appended messages and results made
+ * by forward are not new failures. Each thread counts in its own cache line,
+ * so counting is one unshared increment.
  *
  */
 class Result {
 public:
   Result(ResultCode_t code = ResultCode_t::SUCCESS);
   Result(const Result & result);
+  Result(Result && result) noexcept;
   Result & operator=(const Result & result);
+  Result & operator=(Result && result) noexcept;
   ~Result();
 
-  ResultCode_t    getCode() const;
-  const char *    getMessage() const;
-  const int16_t * getReferenceCount() const;
+  ResultCode_t           getCode() const;
+  const char *           getMessage() const;
+  const ReferenceCount * getReferenceCount() const;
 
   /**
    * @brief Bool cast operator (test for success)
@@ -37,14 +58,315 @@ public:
     return code == ResultCode_t::SUCCESS;
   }
 
-  const friend Result operator+(const Result & left, const char * right);
+  /**
+   * @brief Source location of a deferred message, see FB_HERE
+   */
+  struct Location {
+    const char * file;
+    int          line;
+    const char * function;
+  };
+
+  /**
+   * @brief Format string, arguments and location of a message formatted only
+   * when the message is requested
+   * Each "{}" of the format is replaced by the next argument. Strings are
+   * copied when appended, the format and location must be string literals.
+   * Construct with FB_FORMAT.
+   */
+  class Deferred {
+  public:
+    static const size_t MAX_ARGUMENTS = 8;
+
+    /**
+     * @brief Construct a new Deferred object, capturing each argument
+     *
+     * @tparam Args types of the arguments: bool, characters, integers,
+     * floating point, strings or pointers
+     * @param location of the message, FB_HERE
+     * @param format string literal with a "{}" per argument
+     * @param args to format
+     */
+    template <typename... Args>
+    Deferred(const Location & location, const char * format,
+        const Args &... args) :
+      location(location),
+      format(format), count(sizeof...(Args)) {
+      static_assert(sizeof...(Args) <= MAX_ARGUMENTS,
+          "A deferred message has at most MAX_ARGUMENTS arguments");
+      capture(arguments, args...);
+    }
+
+  private:
+    friend class Result;
+
+    /**
+     * @brief Captured value of an argument
+     */
+    struct Argument {
+      enum class Type_t : uint8_t {
+        BOOL,
+        CHAR,
+        SIGNED,
+        UNSIGNED,
+        DOUBLE,
+        STRING,
+        POINTER
+      };
+
+      Type_t type;
+      size_t length; // Of a string
+      union {
+        int64_t      i;
+        uint64_t     u;
+        double       d;
+        const char * s;
+        const void * p;
+      };
+    };
+
+    /**
+     * @brief Capture no more arguments
+     */
+    static void capture(Argument *) {}
+
+    /**
+     * @brief Capture each argument in order
+     *
+     * @param argument to capture into
+     * @param value of the next argument
+     * @param rest of the arguments
+     */
+    template <typename T, typename... Rest>
+    static void capture(
+        Argument * argument, const T & value, const Rest &... rest) {
+      set(*argument, value);
+      capture(argument + 1, rest...);
+    }
+
+    /**
+     * @brief Capture a bool
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    static void set(Argument & argument, bool value) {
+      argument.type = Argument::Type_t::BOOL;
+      argument.u    = value;
+    }
+
+    /**
+     * @brief Capture a character
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    static void set(Argument & argument, char value) {
+      argument.type = Argument::Type_t::CHAR;
+      argument.u    = static_cast<unsigned char>(value);
+    }
+
+    /**
+     * @brief Capture a signed integer
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value &&
+                                   std::is_signed<T>::value>::type
+    set(Argument & argument, T value) {
+      argument.type = Argument::Type_t::SIGNED;
+      argument.i    = value;
+    }
+
+    /**
+     * @brief Capture an unsigned integer
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value &&
+                                   std::is_unsigned<T>::value>::type
+    set(Argument & argument, T value) {
+      argument.type = Argument::Type_t::UNSIGNED;
+      argument.u    = value;
+    }
+
+    /**
+     * @brief Capture a floating point number
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    set(Argument & argument, T value) {
+      argument.type = Argument::Type_t::DOUBLE;
+      argument.d    = static_cast<double>(value);
+    }
+
+    /**
+     * @brief Capture a null terminated string, copied when appended
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    static void set(Argument & argument, const char * value) {
+      argument.type   = Argument::Type_t::STRING;
+      argument.s      = value == nullptr ? "(null)" : value;
+      argument.length = strlen(argument.s);
+    }
+
+    /**
+     * @brief Capture a string, copied when appended
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    static void set(Argument & argument, const std::string & value) {
+      argument.type   = Argument::Type_t::STRING;
+      argument.s      = value.c_str();
+      argument.length = value.length();
+    }
+
+    /**
+     * @brief Capture a pointer, formatted as its address
+     *
+     * @param argument to capture into
+     * @param value of the argument
+     */
+    static void set(Argument & argument, const void * value) {
+      argument.type = Argument::Type_t::POINTER;
+      argument.p    = value;
+    }
+
+    Location     location;
+    const char * format;
+    size_t       count;
+    Argument     arguments[MAX_ARGUMENTS];
+  };
+
+  friend Result operator+(const Result & left, const char * right);
+  friend Result operator+(const Result & left, const Deferred & right);
+
+  /**
+   * @brief Memory held for messages across every thread
+   */
+  struct MemoryStatistics {
+    size_t inUse;     // Bytes referenced by results
+    size_t reserved;  // Bytes from the global allocator, in use or cached
+    size_t highWater; // Largest reserved since the program started
+  };
+
+  static MemoryStatistics getMemoryStatistics();
+  static void             releaseMemory();
+
+  /**
+   * @brief Failures created of each code across every thread, see
+   * FRUIT_BOWL_RESULT_TELEMETRY
+   */
+  struct ErrorStatistics {
+    uint64_t counts[Results::COUNT]; // Indexed by code, SUCCESS is always 0
+  };
+
+  static ErrorStatistics getErrorStatistics();
+
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  static void countFailure(ResultCode_t code);
+#else
+  /**
+   * @brief Count a new failure, nothing without FRUIT_BOWL_RESULT_TELEMETRY
+   */
+  static inline void countFailure(ResultCode_t) {}
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+
+  /**
+   * @brief Create a result holding an existing failure's code, not counted as
+   * a new failure
+   *
+   * @param code of the failure
+   * @return Result without a message
+   */
+  static inline Result forward(ResultCode_t code) {
+    Result result;
+    result.code = code;
+    return result;
+  }
 
 private:
-  ResultCode_t code           = ResultCode_t::SUCCESS;
-  char *       message        = nullptr;
-  int16_t *    referenceCount = nullptr;
+  /**
+   * @brief Single appended string of a message
+   * Frames are immutable once created, apart from the cache of the formatted
+   * message, and hold a reference to their parent (previously appended) frame
+   * Results sharing a frame may be used from different threads
+   */
+  struct Frame {
+    ReferenceCount referenceCount;
+    bool           deferred; // text holds a Captured, see createFrame
+    Frame *        parent;
+#ifdef FRUIT_BOWL_NO_THREADS
+    mutable char * rendered;
+#else
+    mutable std::atomic<char *> rendered;
+#endif /* FRUIT_BOWL_NO_THREADS */
+    mutable size_t renderedLength; // Formatted length, rendered may hold '\0'
+    size_t         length;
+    char           text[1];
+  };
+
+  static Frame *     createFrame(Frame * parent, const char * text);
+  static Frame *     createFrame(Frame * parent, const Deferred & deferred);
+  static std::string formatFrame(const Frame * frame);
+  static void        releaseFrame(Frame * frame);
+  static void *      allocate(size_t size);
+  static void        deallocate(void * memory, size_t size);
+
+  ResultCode_t code  = ResultCode_t::SUCCESS;
+  Frame *      frame = nullptr;
 };
 
+Result operator+(const Result & left, const char * right);
+Result operator+(const Result & left, const Result::Deferred & right);
+
+/**
+ * @brief Source location of the calling code
+ */
+#define FB_HERE (Result::Location{__FILE__, __LINE__, __func__})
+
+/**
+ * @brief Create a deferred message at the calling code's location
+ * result + FB_FORMAT("n={}", n) appends "n=8 (main.cpp:20 testRecursion)"
+ * when the message is requested, costing only the frame until then
+ */
+#define FB_FORMAT(...) (Result::Deferred(FB_HERE, __VA_ARGS__))
+
+/**
+ * @brief Addition operator for appending a string to a code
+ * Operator lookup does not consider implicit conversions when neither operand
+ * is a class, so a code needs its own overload to promote to a Result
+ *
+ * @param left hand side - a code
+ * @param right hand side - a string to append
+ * @return Result combined result
+ */
+inline Result operator+(const ResultCode_t & left, const char * right) {
+  return Result(left) + right;
+}
+
+/**
+ * @brief Addition operator for appending a deferred message to a code
+ *
+ * @param left hand side - a code
+ * @param right hand side - a deferred message to append
+ * @return Result combined result
+ */
+inline Result operator+(
+    const ResultCode_t & left, const Result::Deferred & right) {
+  return Result(left) + right;
+}
+
 /**
  * @brief Boolean not operator (test for failure)
  *
@@ -77,6 +399,18 @@ inline bool operator==(const Result & left, const ResultCode_t & right) {
   return left.getCode() == right;
 }
 
+/**
+ * @brief Boolean equality operator
+ * Compares without converting the code to a Result, which is a new failure
+ *
+ * @param left hand side
+ * @param right hand side
+ * @return left == right.code
+ */
+inline bool operator==(const ResultCode_t & left, const Result & right) {
+  return left == right.getCode();
+}
+
 /**
  * @brief Boolean inequality operator
  *
@@ -99,6 +433,17 @@ inline bool operator!=(const Result & left, const ResultCode_t & right) {
   return left.getCode() != right;
 }
 
+/**
+ * @brief Boolean inequality operator
+ *
+ * @param left hand side
+ * @param right hand side
+ * @return left != right.code
+ */
+inline bool operator!=(const ResultCode_t & left, const Result & right) {
+  return left != right.getCode();
+}
+
 /**
  * @brief Addition operator for appending a string
  *
@@ -111,5 +456,7 @@ inline Result operator+(const Result & left, const std::string & right) {
 }
 
 std::ostream & operator<<(std::ostream & stream, const Result & result);
+std::ostream & operator<<(
+    std::ostream & stream, const Result::ErrorStatistics & statistics);
 
 #endif /* _FB_RESULT_H_ */
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef _FB_RESULT_CODE_H_
 #define _FB_RESULT_CODE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 enum class ResultCode_t : uint8_t {
@@ -83,6 +84,11 @@ static const char * MESSAGES[] = {
 };
 // clang-format on
 
+/**
+ * @brief Number of result codes, each has a message
+ */
+static const size_t COUNT = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+
 } // namespace Results
 
 #endif /* _FB_RESULT_CODE_H_ */
\ No newline at end of file
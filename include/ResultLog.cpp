@@ -0,0 +1,280 @@
+#include "ResultLog.h"
+
+#include <cstring>
+
+const std::chrono::milliseconds ResultLog::INTERVAL(10);
+
+/**
+ * @brief Construct a new Result Log object, starting its writing thread
+ *
+ * @param stream to write to, must outlive the log
+ * @param capacity most results waiting to be written, rounded up to a power
+ * of 2, also the most messages whose repeats are tracked
+ * @param window duration repeats of a written message are counted instead of
+ * written, 0 to write every message
+ */
+ResultLog::ResultLog(std::ostream & stream, size_t capacity,
+    std::chrono::milliseconds window) :
+  stream(stream), capacity(2), window(window) {
+  while (this->capacity < capacity)
+    this->capacity *= 2;
+#ifndef FRUIT_BOWL_NO_THREADS
+  mask = this->capacity - 1;
+  slots.reset(new Slot[this->capacity]);
+  for (size_t i = 0; i < this->capacity; ++i)
+    slots[i].sequence.store(i, std::memory_order_relaxed);
+  thread = std::thread(&ResultLog::run, this);
+#endif /* FRUIT_BOWL_NO_THREADS */
+}
+
+/**
+ * @brief Destroy the Result Log object
+ * Write every result logged, then the repeats of every message in its window
+ */
+ResultLog::~ResultLog() {
+#ifdef FRUIT_BOWL_NO_THREADS
+  expire(Clock_t::now(), true);
+  writeBatch();
+#else
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  thread.join();
+#endif /* FRUIT_BOWL_NO_THREADS */
+}
+
+#ifdef FRUIT_BOWL_NO_THREADS
+/**
+ * @brief Write a result, or count it if it repeats a message in its window
+ *
+ * @param result to write
+ * @return true always
+ */
+bool ResultLog::log(const Result & result) {
+  Clock_t::time_point now = Clock_t::now();
+  ++logged;
+  if (now - expiredAt >= INTERVAL) {
+    expire(now, false);
+    expiredAt = now;
+  }
+  write(result, now);
+  writeBatch();
+  return true;
+}
+
+/**
+ * @brief Flush the stream, every result is already written
+ */
+void ResultLog::flush() {
+  stream.flush();
+}
+
+/**
+ * @brief Get the counts of results since the log was created
+ *
+ * @return Statistics
+ */
+ResultLog::Statistics ResultLog::getStatistics() const {
+  return Statistics{logged, written, coalesced, 0};
+}
+#else
+/**
+ * @brief Queue a result to be written, without waiting
+ * Only a reference to the message is taken, it is formatted when written
+ *
+ * @param result to write
+ * @return true if queued
+ * @return false if dropped as capacity results are waiting
+ */
+bool ResultLog::log(const Result & result) {
+  size_t position = tail.load(std::memory_order_relaxed);
+  Slot * slot     = nullptr;
+  for (;;) {
+    slot              = &slots[position & mask];
+    size_t   sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (tail.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed))
+        break;
+    } else if (difference < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = tail.load(std::memory_order_relaxed);
+    }
+  }
+  slot->result = result;
+  slot->sequence.store(position + 1, std::memory_order_release);
+  // Wake the writer each half ring rather than waiting out its interval
+  if ((position & (mask >> 1)) == 0)
+    wake.notify_one();
+  return true;
+}
+
+/**
+ * @brief Wait until every result logged before the call is written and the
+ * stream is flushed
+ * Results still being copied in by a logger are waited for, the writer keeps
+ * draining without sleeping until the batches reach them
+ */
+void ResultLog::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  size_t                       target = tail.load(std::memory_order_relaxed);
+  ++flushes;
+  wake.notify_one();
+  drained.wait(lock, [&]() {
+    return static_cast<intptr_t>(writtenTo - target) >= 0;
+  });
+  --flushes;
+}
+
+/**
+ * @brief Get the counts of results since the log was created
+ * Counters are read without stopping the loggers so the snapshot may be
+ * slightly out of date
+ *
+ * @return Statistics
+ */
+ResultLog::Statistics ResultLog::getStatistics() const {
+  return Statistics{tail.load(std::memory_order_relaxed),
+      written.load(std::memory_order_relaxed),
+      coalesced.load(std::memory_order_relaxed),
+      dropped.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Take the oldest result from the ring, only called by the writing
+ * thread
+ *
+ * @param result output oldest result
+ * @return true if a result was taken
+ * @return false if the ring is empty or its oldest result is still being
+ * copied in
+ */
+bool ResultLog::pop(Result & result) {
+  Slot & slot = slots[head & mask];
+  if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+    return false;
+  result = std::move(slot.result);
+  slot.sequence.store(head + capacity, std::memory_order_release);
+  ++head;
+  return true;
+}
+
+/**
+ * @brief Write up to capacity results and the repeats of expired windows as
+ * one batch
+ *
+ * @return size_t number of results taken from the ring
+ */
+size_t ResultLog::drain() {
+  Clock_t::time_point now = Clock_t::now();
+  Result              result;
+  size_t              taken = 0;
+  while (taken < capacity && pop(result)) {
+    write(result, now);
+    ++taken;
+  }
+  result = Result();
+  expire(now, false);
+  writeBatch();
+  return taken;
+}
+
+/**
+ * @brief Write batches until the log is destroyed
+ * Sleeps for INTERVAL between batches unless woken by flush or by a filling
+ * ring, a batch of a quarter ring or more is followed by the next at once
+ */
+void ResultLog::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    lock.unlock();
+    size_t taken = drain();
+    lock.lock();
+    writtenTo = head;
+    drained.notify_all();
+    if (flushes == 0 && !stopping && taken < capacity / 4)
+      wake.wait_for(lock, INTERVAL);
+  }
+  lock.unlock();
+  Result result;
+  while (pop(result))
+    write(result, Clock_t::now());
+  expire(Clock_t::now(), true);
+  writeBatch();
+}
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Append a result's message to the batch, or count it if it repeats a
+ * message in its window
+ * Messages are only tracked while fewer than capacity are, others are always
+ * written
+ *
+ * @param result to write
+ * @param now time the batch started
+ */
+void ResultLog::write(const Result & result, Clock_t::time_point now) {
+  const char * message = result.getMessage();
+  size_t       length  = strlen(message);
+  if (window != Clock_t::duration::zero()) {
+    Repeat * repeat = repeats.find(message, length);
+    if (repeat != nullptr) {
+      ++repeat->count;
+      ++coalesced;
+      return;
+    }
+    if (repeats.size() < capacity)
+      repeats.set(message, length, Repeat{now + window, 0});
+  }
+  batch.append(message, length);
+  batch += '\n';
+  ++written;
+}
+
+/**
+ * @brief Stop tracking messages whose window expired, appending how often
+ * each repeated to the batch
+ *
+ * @param now time the batch started
+ * @param all true to expire every message
+ */
+void ResultLog::expire(Clock_t::time_point now, bool all) {
+  repeats.forEach([&](const std::string & message, Repeat & repeat) {
+    if (!all && repeat.expires > now)
+      return;
+    if (repeat.count != 0)
+      batch += message + "\n  ->repeated " + std::to_string(repeat.count) +
+               " times\n";
+    expired.push_back(message);
+  });
+  for (const std::string & message : expired)
+    repeats.remove(message);
+  expired.clear();
+}
+
+/**
+ * @brief Write the batch to the stream with one write, noting results dropped
+ * since the last batch
+ */
+void ResultLog::writeBatch() {
+#ifndef FRUIT_BOWL_NO_THREADS
+  uint64_t droppedCount = dropped.load(std::memory_order_relaxed);
+  if (droppedCount != reportedDrops) {
+    batch += "ResultLog dropped " +
+             std::to_string(droppedCount - reportedDrops) +
+             " results, the log was full\n";
+    reportedDrops = droppedCount;
+  }
+#endif /* FRUIT_BOWL_NO_THREADS */
+  if (batch.empty())
+    return;
+  stream.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+  stream.flush();
+  batch.clear();
+}
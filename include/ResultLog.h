@@ -0,0 +1,124 @@
+#ifndef _FB_RESULT_LOG_H_
+#define _FB_RESULT_LOG_H_
+
+#include "HashMap.h"
+#include "Result.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef FRUIT_BOWL_NO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+/**
+ * @brief Writes results to a stream without waiting on it
+ * log only copies the result (a reference to its message) into a bounded
+ * ring, any number of threads may log at once without locking. A background
+ * thread formats the messages and writes each batch to the stream with one
+ * write. When the ring is full the result is dropped and counted, memory
+ * never grows with the backlog.
+ *
+ * A message equal to one written within the window (found by its Hash value,
+ * then compared) is not written again but counted, when the window expires
+ * "->repeated N times" follows the message once.
+ *
+ * With FRUIT_BOWL_NO_THREADS defined, log formats and writes on the calling
+ * thread, still removing repeats.
+ *
+ */
+class ResultLog {
+public:
+  /**
+   * @brief Counts of results since the log was created
+   */
+  struct Statistics {
+    uint64_t logged;    // Results accepted by log
+    uint64_t written;   // Messages written to the stream
+    uint64_t coalesced; // Messages repeating one written within the window
+    uint64_t dropped;   // Results not accepted as the ring was full
+  };
+
+  ResultLog(std::ostream & stream, size_t capacity = 4096,
+      std::chrono::milliseconds window = std::chrono::milliseconds(1000));
+  ~ResultLog();
+
+  ResultLog(const ResultLog & log) = delete;
+  ResultLog & operator=(const ResultLog & log) = delete;
+
+  bool       log(const Result & result);
+  void       flush();
+  Statistics getStatistics() const;
+
+private:
+  typedef std::chrono::steady_clock Clock_t;
+
+  /**
+   * @brief Time between batches while results are arriving
+   */
+  static const std::chrono::milliseconds INTERVAL;
+
+  /**
+   * @brief Message written within the window and how often it repeated since
+   */
+  struct Repeat {
+    Clock_t::time_point expires;
+    uint64_t            count;
+  };
+
+  void write(const Result & result, Clock_t::time_point now);
+  void expire(Clock_t::time_point now, bool all);
+  void writeBatch();
+
+  std::ostream &           stream;
+  size_t                   capacity;
+  Clock_t::duration        window;
+  HashMap<Repeat>          repeats;
+  std::vector<std::string> expired;
+  std::string              batch;
+
+#ifdef FRUIT_BOWL_NO_THREADS
+  uint64_t            logged    = 0;
+  uint64_t            written   = 0;
+  uint64_t            coalesced = 0;
+  Clock_t::time_point expiredAt;
+#else
+  /**
+   * @brief Ring entry, sequence tells whose turn it is: its position while
+   * free for a producer, position + 1 once holding a result for the consumer
+   */
+  struct Slot {
+    std::atomic<size_t> sequence;
+    Result              result;
+  };
+
+  bool   pop(Result & result);
+  size_t drain();
+  void   run();
+
+  std::unique_ptr<Slot[]> slots;
+  size_t                  mask;
+  std::atomic<size_t>     tail{0}; // Next position to log, results logged
+  std::atomic<uint64_t>   dropped{0};
+  alignas(64) size_t      head = 0; // Next position to write, off tail's line
+  std::atomic<uint64_t>   written{0};
+  std::atomic<uint64_t>   coalesced{0};
+  uint64_t                reportedDrops = 0;
+  std::mutex              mutex;
+  std::condition_variable wake;
+  std::condition_variable drained;
+  size_t                  writtenTo = 0; // Position every batch reached
+  int                     flushes   = 0;
+  bool                    stopping  = false;
+  std::thread             thread;
+#endif /* FRUIT_BOWL_NO_THREADS */
+};
+
+#endif /* _FB_RESULT_LOG_H_ */
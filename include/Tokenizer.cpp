@@ -0,0 +1,232 @@
+#include "CPU.h"
+#include "Tokenizer.h"
+
+#ifdef FRUIT_BOWL_X86
+#include <immintrin.h>
+#endif /* FRUIT_BOWL_X86 */
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+
+/**
+ * @brief Get the position of the lowest set bit
+ *
+ * @param mask to search, not zero
+ * @return uint32_t position
+ */
+static inline uint32_t lowestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return index;
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanForward(&index, static_cast<uint32_t>(mask)))
+    return index;
+  _BitScanForward(&index, static_cast<uint32_t>(mask >> 32));
+  return index + 32;
+#else
+  return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * @brief Append the offset of each set bit of a mask
+ *
+ * @param mask of delimiters, bit i set for character i
+ * @param base offset of bit 0
+ * @param offsets output
+ * @param found number of offsets so far
+ * @return size_t number of offsets
+ */
+static inline size_t appendOffsets(
+    uint64_t mask, uint32_t base, uint32_t * offsets, size_t found) {
+  while (mask != 0) {
+    offsets[found++] = base + lowestBit(mask);
+    mask &= mask - 1;
+  }
+  return found;
+}
+
+/**
+ * @brief Find the delimiters one character at a time
+ *
+ * @param characters delimiters, unused
+ * @param count number of delimiters, unused
+ * @param table true for each delimiter character
+ * @param c array to search
+ * @param length number of characters
+ * @param offsets output offset of each delimiter
+ * @return size_t number of delimiters found
+ */
+static size_t findScalar(const char * characters, size_t count,
+    const bool * table, const char * c, size_t length, uint32_t * offsets) {
+  (void)characters;
+  (void)count;
+  size_t found = 0;
+  for (size_t i = 0; i < length; ++i) {
+    if (table[static_cast<unsigned char>(c[i])])
+      offsets[found++] = static_cast<uint32_t>(i);
+  }
+  return found;
+}
+
+#ifdef FRUIT_BOWL_X86
+/**
+ * @brief Find the delimiters 16 characters at a time with SSE2
+ *
+ * @param characters delimiters
+ * @param count number of delimiters
+ * @param table true for each delimiter character
+ * @param c array to search
+ * @param length number of characters
+ * @param offsets output offset of each delimiter
+ * @return size_t number of delimiters found
+ */
+FB_TARGET("sse2")
+static size_t findSSE2(const char * characters, size_t count,
+    const bool * table, const char * c, size_t length, uint32_t * offsets) {
+  __m128i delimiters[Delimiters::MAX_VECTOR];
+  for (size_t k = 0; k < count; ++k)
+    delimiters[k] = _mm_set1_epi8(characters[k]);
+
+  size_t found = 0;
+  size_t i     = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + i));
+    __m128i match = _mm_setzero_si128();
+    for (size_t k = 0; k < count; ++k)
+      match = _mm_or_si128(match, _mm_cmpeq_epi8(block, delimiters[k]));
+    uint64_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    found = appendOffsets(mask, static_cast<uint32_t>(i), offsets, found);
+  }
+  size_t tail = findScalar(characters, count, table, c + i, length - i,
+      offsets + found);
+  for (size_t k = found; k < found + tail; ++k)
+    offsets[k] += static_cast<uint32_t>(i);
+  return found + tail;
+}
+
+/**
+ * @brief Find the delimiters 64 characters at a time with AVX2
+ *
+ * @param characters delimiters
+ * @param count number of delimiters
+ * @param table true for each delimiter character
+ * @param c array to search
+ * @param length number of characters
+ * @param offsets output offset of each delimiter
+ * @return size_t number of delimiters found
+ */
+FB_TARGET("avx2")
+static size_t findAVX2(const char * characters, size_t count,
+    const bool * table, const char * c, size_t length, uint32_t * offsets) {
+  __m256i delimiters[Delimiters::MAX_VECTOR];
+  for (size_t k = 0; k < count; ++k)
+    delimiters[k] = _mm256_set1_epi8(characters[k]);
+
+  size_t found = 0;
+  size_t i     = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i));
+    __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i + 32));
+    __m256i matchLow  = _mm256_setzero_si256();
+    __m256i matchHigh = _mm256_setzero_si256();
+    for (size_t k = 0; k < count; ++k) {
+      matchLow =
+          _mm256_or_si256(matchLow, _mm256_cmpeq_epi8(low, delimiters[k]));
+      matchHigh =
+          _mm256_or_si256(matchHigh, _mm256_cmpeq_epi8(high, delimiters[k]));
+    }
+    uint64_t mask =
+        static_cast<uint32_t>(_mm256_movemask_epi8(matchLow)) |
+        static_cast<uint64_t>(static_cast<uint32_t>(
+            _mm256_movemask_epi8(matchHigh)))
+            << 32;
+    found = appendOffsets(mask, static_cast<uint32_t>(i), offsets, found);
+  }
+  size_t tail = findSSE2(characters, count, table, c + i, length - i,
+      offsets + found);
+  for (size_t k = found; k < found + tail; ++k)
+    offsets[k] += static_cast<uint32_t>(i);
+  return found + tail;
+}
+
+/**
+ * @brief Find the delimiters 64 characters at a time with AVX-512
+ * The tail is read with a masked load so no character is searched twice
+ *
+ * @param characters delimiters
+ * @param count number of delimiters
+ * @param table true for each delimiter character, unused
+ * @param c array to search
+ * @param length number of characters
+ * @param offsets output offset of each delimiter
+ * @return size_t number of delimiters found
+ */
+FB_TARGET("avx512f,avx512bw")
+static size_t findAVX512(const char * characters, size_t count,
+    const bool * table, const char * c, size_t length, uint32_t * offsets) {
+  (void)table;
+  __m512i delimiters[Delimiters::MAX_VECTOR];
+  for (size_t k = 0; k < count; ++k)
+    delimiters[k] = _mm512_set1_epi8(characters[k]);
+
+  size_t found = 0;
+  for (size_t i = 0; i < length; i += 64) {
+    __mmask64 valid = length - i >= 64 ? ~static_cast<__mmask64>(0)
+                                       : (static_cast<__mmask64>(1)
+                                             << (length - i)) - 1;
+    __m512i   block = _mm512_maskz_loadu_epi8(valid, c + i);
+    __mmask64 match = 0;
+    for (size_t k = 0; k < count; ++k)
+      match |= _mm512_cmpeq_epi8_mask(block, delimiters[k]);
+    found = appendOffsets(
+        match & valid, static_cast<uint32_t>(i), offsets, found);
+  }
+  return found;
+}
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Construct a new Delimiters object
+ * Selects the widest search the processor supports
+ *
+ * @param delimiters characters
+ * @param count number of characters
+ */
+Delimiters::Delimiters(const char * delimiters, size_t count) :
+  characters(), count(count), table(), function(findScalar) {
+  for (size_t i = 0; i < count; ++i) {
+    table[static_cast<unsigned char>(delimiters[i])] = true;
+    if (i < MAX_VECTOR)
+      characters[i] = delimiters[i];
+  }
+#ifdef FRUIT_BOWL_X86
+  if (count <= MAX_VECTOR) {
+    const CPU::Features & cpu = CPU::getFeatures();
+    if (cpu.avx512bw)
+      function = findAVX512;
+    else if (cpu.avx2)
+      function = findAVX2;
+    else if (cpu.sse2)
+      function = findSSE2;
+  }
+#endif /* FRUIT_BOWL_X86 */
+}
+
+/**
+ * @brief Find the delimiters of a character array
+ *
+ * @param c array to search
+ * @param length number of characters, less than 2^32
+ * @param offsets output offset of each delimiter, room for length offsets
+ * @return size_t number of delimiters found
+ */
+size_t Delimiters::find(
+    const char * c, size_t length, uint32_t * offsets) const {
+  return function(characters, count, table, c, length, offsets);
+}
@@ -0,0 +1,162 @@
+#ifndef _FB_TOKENIZER_H_
+#define _FB_TOKENIZER_H_
+
+#include "HashAlgorithm.h"
+
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set of delimiter characters found in bulk
+ * Up to 8 delimiters are compared 16, 32 or 64 characters at a time (SSE2,
+ * AVX2 or AVX-512 as supported by the processor), more are looked up one
+ * character at a time.
+ *
+ */
+class Delimiters {
+public:
+  Delimiters(const char * delimiters, size_t count);
+
+  size_t find(const char * c, size_t length, uint32_t * offsets) const;
+
+  /**
+   * @brief Check if a character is a delimiter
+   *
+   * @param c character to check
+   * @return true if c is a delimiter
+   */
+  inline bool contains(const char c) const {
+    return table[static_cast<unsigned char>(c)];
+  }
+
+  /**
+   * @brief Maximum number of delimiters compared with vector instructions
+   */
+  static const size_t MAX_VECTOR = 8;
+
+private:
+  /**
+   * @brief Function finding the delimiters of a character array
+   */
+  typedef size_t (*Find_t)(const char * characters, size_t count,
+      const bool * table, const char * c, size_t length, uint32_t * offsets);
+
+  char   characters[MAX_VECTOR];
+  size_t count;
+  bool   table[256];
+  Find_t function;
+};
+
+/**
+ * @brief Splits character arrays into tokens between delimiters, hashing
+ * each token as it is found
+ * Delimiters are found a window at a time and the window's tokens hashed while
+ * it is still in cache, so memory is read once. Tokens are views into the
+ * input, nothing is copied. Hashes match BasicHash of the same algorithm.
+ *
+ * @tparam Algorithm to calculate the hashes with
+ */
+template <class Algorithm>
+class BasicTokenizer {
+public:
+  typedef typename Algorithm::Value_t Value_t;
+
+  /**
+   * @brief Characters between two delimiters and their hash
+   */
+  struct Token {
+    const char * c;
+    size_t       length;
+    Value_t      hash;
+  };
+
+  /**
+   * @brief Construct a new Tokenizer object
+   *
+   * @param delimiters null terminated string of delimiter characters
+   */
+  BasicTokenizer(const char * delimiters) :
+    delimiters(delimiters, strlen(delimiters)) {}
+
+  /**
+   * @brief Construct a new Tokenizer object
+   *
+   * @param delimiters string of delimiter characters, may include '\0'
+   */
+  BasicTokenizer(const std::string & delimiters) :
+    delimiters(delimiters.c_str(), delimiters.length()) {}
+
+  /**
+   * @brief Split a character array into tokens
+   * Adjacent delimiters give empty tokens. The characters after the final
+   * delimiter are a token if there are any and last is true, else they are
+   * left to be prepended to the next array of a stream.
+   *
+   * @tparam Function callable as function(const Token &)
+   * @param c array to split
+   * @param length number of characters
+   * @param function to call with each token in order
+   * @param last if true the array is the end of the input
+   * @return size_t number of characters consumed, all of them if last is true
+   */
+  template <class Function>
+  size_t tokenize(const char * c, size_t length, Function function,
+      bool last = true) const {
+    uint32_t offsets[WINDOW];
+    size_t   start = 0;
+    for (size_t window = 0; window < length; window += WINDOW) {
+      size_t n     = length - window < WINDOW ? length - window : WINDOW;
+      size_t found = delimiters.find(c + window, n, offsets);
+      for (size_t i = 0; i < found; ++i) {
+        size_t end   = window + offsets[i];
+        Token  token = {c + start, end - start,
+            Algorithm::calculate(c + start, end - start)};
+        function(token);
+        start = end + 1;
+      }
+    }
+    if (!last)
+      return start;
+    if (start < length) {
+      Token token = {c + start, length - start,
+          Algorithm::calculate(c + start, length - start)};
+      function(token);
+    }
+    return length;
+  }
+
+  /**
+   * @brief Split a character array into tokens
+   *
+   * @param c array to split
+   * @param length number of characters
+   * @param tokens output, each token is appended in order
+   * @param last if true the array is the end of the input
+   * @return size_t number of characters consumed, all of them if last is true
+   */
+  size_t tokenize(const char * c, size_t length, std::vector<Token> & tokens,
+      bool last = true) const {
+    return tokenize(
+        c, length, [&](const Token & token) { tokens.push_back(token); },
+        last);
+  }
+
+private:
+  /**
+   * @brief Number of characters searched for delimiters at a time
+   */
+  static constexpr size_t WINDOW = 2048;
+
+  Delimiters delimiters;
+};
+
+template <class Algorithm>
+constexpr size_t BasicTokenizer<Algorithm>::WINDOW;
+
+typedef BasicTokenizer<Jenkins> Tokenizer;
+typedef BasicTokenizer<XXH64>   TokenizerXXH64;
+typedef BasicTokenizer<WyHash>  TokenizerWy;
+
+#endif /* _FB_TOKENIZER_H_ */
@@ -0,0 +1,477 @@
+#include "CPU.h"
+#include "UTF8.h"
+
+#include <cstring>
+
+#ifdef FRUIT_BOWL_X86
+#include <immintrin.h>
+#endif /* FRUIT_BOWL_X86 */
+
+namespace UTF8 {
+
+/**
+ * @brief Function finding the first invalid sequence of a character array
+ */
+typedef size_t (*Find_t)(const char * c, size_t length);
+
+/**
+ * @brief Check if a character continues a multibyte sequence, 10xxxxxx
+ *
+ * @param c character to check
+ * @return true if c is a continuation character
+ */
+static inline bool isContinuation(const char c) {
+  return (static_cast<uint8_t>(c) & 0xC0) == 0x80;
+}
+
+/**
+ * @brief Find the first invalid sequence one character at a time
+ * Runs of ASCII are skipped 8 characters at a time
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+static size_t findInvalidScalar(const char * c, size_t length) {
+  const uint8_t * s = reinterpret_cast<const uint8_t *>(c);
+  size_t          i = 0;
+  while (i < length) {
+    if (length - i >= 8) {
+      uint64_t word;
+      memcpy(&word, s + i, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+    uint8_t lead = s[i];
+    if (lead < 0x80) {
+      ++i;
+      continue;
+    }
+
+    // Bounds of the second character reject overlong encodings, surrogates
+    // and code points above U+10FFFF
+    size_t  n    = 0;
+    uint8_t low  = 0x80;
+    uint8_t high = 0xBF;
+    if (lead < 0xC2)
+      return i;
+    else if (lead < 0xE0)
+      n = 1;
+    else if (lead < 0xF0) {
+      n = 2;
+      if (lead == 0xE0)
+        low = 0xA0;
+      else if (lead == 0xED)
+        high = 0x9F;
+    } else if (lead < 0xF5) {
+      n = 3;
+      if (lead == 0xF0)
+        low = 0x90;
+      else if (lead == 0xF4)
+        high = 0x8F;
+    } else
+      return i;
+
+    if (length - i <= n || s[i + 1] < low || s[i + 1] > high)
+      return i;
+    for (size_t k = 2; k <= n; ++k) {
+      if (!isContinuation(c[i + k]))
+        return i;
+    }
+    i += n + 1;
+  }
+  return length;
+}
+
+/**
+ * @brief Find the first invalid sequence at or after a block, every character
+ * before the block being valid apart from a truncated final sequence
+ * Restarts one character at a time from the start of the sequence the block
+ * begins in, up to 3 characters before it
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @param block offset of the block
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+static size_t findInvalidFrom(const char * c, size_t length, size_t block) {
+  size_t start = block < 3 ? 0 : block - 3;
+  while (start < block && isContinuation(c[start]))
+    ++start;
+  return start + findInvalidScalar(c + start, length - start);
+}
+
+#ifdef FRUIT_BOWL_X86
+// Error classes of a character and the one before it (Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte"). A pair is
+// invalid if its three lookups share a set bit.
+static const uint8_t TOO_SHORT      = 1 << 0;
+static const uint8_t TOO_LONG       = 1 << 1;
+static const uint8_t OVERLONG_3     = 1 << 2;
+static const uint8_t TOO_LARGE      = 1 << 3;
+static const uint8_t SURROGATE      = 1 << 4;
+static const uint8_t OVERLONG_2     = 1 << 5;
+static const uint8_t TOO_LARGE_1000 = 1 << 6;
+static const uint8_t OVERLONG_4     = 1 << 6;
+static const uint8_t TWO_CONTS      = 1 << 7;
+static const uint8_t CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+/**
+ * @brief Errors by the high nibble of the previous character
+ */
+alignas(16) static const uint8_t BYTE_1_HIGH[16] = {
+    // 0xxx ASCII
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TOO_LONG,
+    // 10xx continuation
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    // 1100 two character lead
+    TOO_SHORT | OVERLONG_2,
+    // 1101 two character lead
+    TOO_SHORT,
+    // 1110 three character lead
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111 four character lead
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4};
+
+/**
+ * @brief Errors by the low nibble of the previous character
+ */
+alignas(16) static const uint8_t BYTE_1_LOW[16] = {
+    // xxxx0000
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    // xxxx0001
+    CARRY | OVERLONG_2,
+    // xxxx001x
+    CARRY, CARRY,
+    // xxxx0100
+    CARRY | TOO_LARGE,
+    // xxxx0101 to xxxx1100
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    // xxxx1101
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    // xxxx111x
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000};
+
+/**
+ * @brief Errors by the high nibble of the character
+ */
+alignas(16) static const uint8_t BYTE_2_HIGH[16] = {
+    // 0xxx ASCII
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_SHORT, TOO_SHORT,
+    // 1000
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+        OVERLONG_4,
+    // 1001
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    // 101x
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    // 11xx lead
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT};
+
+/**
+ * @brief Maximum final characters of a block not starting a sequence
+ * truncated by the block's end
+ */
+alignas(16) static const uint8_t INCOMPLETE_MAX[16] = {0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+/**
+ * @brief Find the errors of 16 characters with SSSE3
+ *
+ * @param input characters
+ * @param prev previous 16 characters
+ * @return __m128i non zero where a character is invalid
+ */
+FB_TARGET("ssse3")
+static inline __m128i checkSSSE3(__m128i input, __m128i prev) {
+  const __m128i nibble  = _mm_set1_epi8(0x0F);
+  const __m128i prev1   = _mm_alignr_epi8(input, prev, 15);
+  const __m128i byte1H  = _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_HIGH)),
+      _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+  const __m128i byte1L  = _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_LOW)),
+      _mm_and_si128(prev1, nibble));
+  const __m128i byte2H  = _mm_shuffle_epi8(
+      _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_2_HIGH)),
+      _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+  const __m128i special = _mm_and_si128(_mm_and_si128(byte1H, byte1L), byte2H);
+
+  // Third and fourth characters of a sequence must be continuations, these
+  // are the TWO_CONTS pairs which are valid
+  const __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+  const __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+  const __m128i must23 =
+      _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+          _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80)));
+  return _mm_xor_si128(
+      _mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80))), special);
+}
+
+/**
+ * @brief Find the first invalid sequence 64 characters at a time with SSSE3
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+FB_TARGET("ssse3")
+static size_t findInvalidSSSE3(const char * c, size_t length) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i incompleteMax =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(INCOMPLETE_MAX));
+  __m128i prev           = zero;
+  __m128i prevIncomplete = zero;
+  size_t  i              = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m128i block[4];
+    for (size_t k = 0; k < 4; ++k)
+      block[k] =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + i + 16 * k));
+    __m128i ascii = _mm_or_si128(
+        _mm_or_si128(block[0], block[1]), _mm_or_si128(block[2], block[3]));
+
+    __m128i error = prevIncomplete;
+    if (_mm_movemask_epi8(ascii) == 0) {
+      prevIncomplete = zero;
+    } else {
+      error = zero;
+      for (size_t k = 0; k < 4; ++k) {
+        error = _mm_or_si128(error, checkSSSE3(block[k], prev));
+        prev  = block[k];
+      }
+      prevIncomplete = _mm_subs_epu8(block[3], incompleteMax);
+    }
+    prev = block[3];
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF)
+      return findInvalidFrom(c, length, i);
+  }
+  return findInvalidFrom(c, length, i);
+}
+
+/**
+ * @brief Find the errors of 32 characters with AVX2
+ *
+ * @param input characters
+ * @param prev previous 32 characters
+ * @return __m256i non zero where a character is invalid
+ */
+FB_TARGET("avx2")
+static inline __m256i checkAVX2(__m256i input, __m256i prev) {
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  // alignr shifts within 128-bit lanes, so pair each lane with the one
+  // before it
+  const __m256i before  = _mm256_permute2x128_si256(prev, input, 0x21);
+  const __m256i prev1   = _mm256_alignr_epi8(input, before, 15);
+  const __m256i byte1H  = _mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_HIGH))),
+      _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+  const __m256i byte1L  = _mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_LOW))),
+      _mm256_and_si256(prev1, nibble));
+  const __m256i byte2H  = _mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_2_HIGH))),
+      _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+  const __m256i special =
+      _mm256_and_si256(_mm256_and_si256(byte1H, byte1L), byte2H);
+
+  const __m256i prev2  = _mm256_alignr_epi8(input, before, 14);
+  const __m256i prev3  = _mm256_alignr_epi8(input, before, 13);
+  const __m256i must23 = _mm256_or_si256(
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80)),
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80)));
+  return _mm256_xor_si256(
+      _mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80))),
+      special);
+}
+
+/**
+ * @brief Find the first invalid sequence 64 characters at a time with AVX2
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+FB_TARGET("avx2")
+static size_t findInvalidAVX2(const char * c, size_t length) {
+  const __m256i zero          = _mm256_setzero_si256();
+  const __m256i incompleteMax = _mm256_inserti128_si256(
+      _mm256_set1_epi8(static_cast<char>(0xFF)),
+      _mm_load_si128(reinterpret_cast<const __m128i *>(INCOMPLETE_MAX)), 1);
+  __m256i prev           = zero;
+  __m256i prevIncomplete = zero;
+  size_t  i              = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i));
+    __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i + 32));
+
+    __m256i error = prevIncomplete;
+    if (_mm256_movemask_epi8(_mm256_or_si256(low, high)) == 0) {
+      prevIncomplete = zero;
+    } else {
+      error = _mm256_or_si256(checkAVX2(low, prev), checkAVX2(high, low));
+      prevIncomplete = _mm256_subs_epu8(high, incompleteMax);
+    }
+    prev = high;
+    if (!_mm256_testz_si256(error, error))
+      return findInvalidFrom(c, length, i);
+  }
+  return findInvalidFrom(c, length, i);
+}
+
+/**
+ * @brief Find the errors of 64 characters with AVX-512
+ *
+ * @param input characters
+ * @param prev previous 64 characters
+ * @return __m512i non zero where a character is invalid
+ */
+FB_TARGET("avx512f,avx512bw")
+static inline __m512i checkAVX512(__m512i input, __m512i prev) {
+  const __m512i nibble = _mm512_set1_epi8(0x0F);
+  // alignr shifts within 128-bit lanes, so pair each lane with the one
+  // before it: the last lane of prev then the first three of input
+  const __m512i before = _mm512_permutex2var_epi64(
+      prev, _mm512_set_epi64(13, 12, 11, 10, 9, 8, 7, 6), input);
+  const __m512i prev1  = _mm512_alignr_epi8(input, before, 15);
+  const __m512i byte1H = _mm512_shuffle_epi8(
+      _mm512_broadcast_i32x4(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_HIGH))),
+      _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble));
+  const __m512i byte1L = _mm512_shuffle_epi8(
+      _mm512_broadcast_i32x4(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_1_LOW))),
+      _mm512_and_si512(prev1, nibble));
+  const __m512i byte2H = _mm512_shuffle_epi8(
+      _mm512_broadcast_i32x4(
+          _mm_load_si128(reinterpret_cast<const __m128i *>(BYTE_2_HIGH))),
+      _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble));
+  const __m512i special =
+      _mm512_and_si512(_mm512_and_si512(byte1H, byte1L), byte2H);
+
+  const __m512i prev2  = _mm512_alignr_epi8(input, before, 14);
+  const __m512i prev3  = _mm512_alignr_epi8(input, before, 13);
+  const __m512i must23 = _mm512_or_si512(
+      _mm512_subs_epu8(prev2, _mm512_set1_epi8(0xE0 - 0x80)),
+      _mm512_subs_epu8(prev3, _mm512_set1_epi8(0xF0 - 0x80)));
+  return _mm512_xor_si512(
+      _mm512_and_si512(must23, _mm512_set1_epi8(static_cast<char>(0x80))),
+      special);
+}
+
+/**
+ * @brief Find the first invalid sequence 64 characters at a time with
+ * AVX-512
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+FB_TARGET("avx512f,avx512bw")
+static size_t findInvalidAVX512(const char * c, size_t length) {
+  const __m512i zero          = _mm512_setzero_si512();
+  const __m512i incompleteMax = _mm512_inserti32x4(
+      _mm512_set1_epi8(static_cast<char>(0xFF)),
+      _mm_load_si128(reinterpret_cast<const __m128i *>(INCOMPLETE_MAX)), 3);
+  __m512i prev           = zero;
+  __m512i prevIncomplete = zero;
+  size_t  i              = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m512i block = _mm512_loadu_si512(c + i);
+
+    __m512i error = prevIncomplete;
+    if (_mm512_movepi8_mask(block) == 0) {
+      prevIncomplete = zero;
+    } else {
+      error          = checkAVX512(block, prev);
+      prevIncomplete = _mm512_subs_epu8(block, incompleteMax);
+    }
+    prev = block;
+    if (_mm512_test_epi8_mask(error, error) != 0)
+      return findInvalidFrom(c, length, i);
+  }
+  return findInvalidFrom(c, length, i);
+}
+#endif /* FRUIT_BOWL_X86 */
+
+/**
+ * @brief Select the widest validation the processor supports
+ *
+ * @return Find_t function
+ */
+static Find_t select() {
+#ifdef FRUIT_BOWL_X86
+  const CPU::Features & cpu = CPU::getFeatures();
+  if (cpu.avx512bw)
+    return findInvalidAVX512;
+  if (cpu.avx2)
+    return findInvalidAVX2;
+  if (cpu.ssse3)
+    return findInvalidSSSE3;
+#endif /* FRUIT_BOWL_X86 */
+  return findInvalidScalar;
+}
+
+/**
+ * @brief Find the first invalid sequence of a character array
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return size_t offset of the first character of the first invalid
+ * sequence, length if valid
+ */
+size_t findInvalid(const char * c, size_t length) {
+  static const Find_t function = select();
+  return function(c, length);
+}
+
+/**
+ * @brief Find the end of a window of a character array that does not split
+ * a sequence
+ * Validating the windows separately finds the same first invalid sequence as
+ * validating the whole array
+ *
+ * @param c array to split
+ * @param length number of characters
+ * @param end desired end of the window
+ * @return size_t end of the window, at most 3 characters before end
+ */
+size_t findBoundary(const char * c, size_t length, size_t end) {
+  if (end >= length)
+    return length;
+  for (size_t i = 0; i < 4 && i <= end; ++i) {
+    if (!isContinuation(c[end - i]))
+      return end - i;
+  }
+  return end;
+}
+
+/**
+ * @brief Create the result of an invalid sequence
+ *
+ * @param offset of the first character of the sequence
+ * @return Result INVALID_UTF8 with the offset in its message
+ */
+Result getError(size_t offset) {
+  return ResultCode_t::INVALID_UTF8 +
+         ("Invalid UTF-8 sequence at offset " + std::to_string(offset));
+}
+
+} // namespace UTF8
@@ -0,0 +1,83 @@
+#ifndef _FB_UTF8_H_
+#define _FB_UTF8_H_
+
+#include "HashAlgorithm.h"
+#include "Result.h"
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief UTF-8 validation
+ * Checks 64 characters at a time with table lookups on each character and
+ * the three before it (Keiser and Lemire), using SSSE3, AVX2 or AVX-512 as
+ * supported by the processor, else one character at a time. Rejects overlong
+ * encodings, surrogates, code points above U+10FFFF and truncated sequences.
+ *
+ */
+namespace UTF8 {
+
+size_t findInvalid(const char * c, size_t length);
+size_t findBoundary(const char * c, size_t length, size_t end);
+Result getError(size_t offset);
+
+/**
+ * @brief Number of characters validated and hashed at a time
+ */
+static const size_t WINDOW = 4096;
+
+/**
+ * @brief Validate a character array as UTF-8
+ *
+ * @param c array to validate
+ * @param length number of characters
+ * @return Result INVALID_UTF8 with the offset of the first invalid sequence
+ */
+inline Result validate(const char * c, size_t length) {
+  size_t offset = findInvalid(c, length);
+  return offset == length ? Result(ResultCode_t::SUCCESS) : getError(offset);
+}
+
+/**
+ * @brief Validate a string as UTF-8
+ *
+ * @param str to validate
+ * @return Result INVALID_UTF8 with the offset of the first invalid sequence
+ */
+inline Result validate(const std::string & str) {
+  return validate(str.c_str(), str.length());
+}
+
+/**
+ * @brief Validate a character array as UTF-8 and hash it
+ * Each window is hashed right after it is validated, while it is still in
+ * cache, so memory is read once. The hash equals Algorithm::calculate.
+ *
+ * @tparam Algorithm to calculate the hash with
+ * @param c array to validate and hash
+ * @param length number of characters
+ * @param hash output, only written if the array is valid
+ * @param seed to start the hash from
+ * @return Result INVALID_UTF8 with the offset of the first invalid sequence
+ */
+template <class Algorithm = Jenkins>
+Result validateAndHash(const char * c, size_t length,
+    typename Algorithm::Value_t & hash,
+    typename Algorithm::Seed_t    seed = Algorithm::SEED) {
+  typename Algorithm::State_t state;
+  Algorithm::init(state, seed);
+  for (size_t start = 0; start < length;) {
+    size_t end    = findBoundary(c, length, start + WINDOW);
+    size_t offset = findInvalid(c + start, end - start);
+    if (offset != end - start)
+      return getError(start + offset);
+    Algorithm::update(state, c + start, end - start);
+    start = end;
+  }
+  hash = Algorithm::finish(state);
+  return ResultCode_t::SUCCESS;
+}
+
+} // namespace UTF8
+
+#endif /* _FB_UTF8_H_ */
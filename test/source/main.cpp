@@ -1,10 +1,20 @@
 #include <FruitBowl.h>
 #include <Result.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 Result testRecursion(int n) {
   if (n == 0)
@@ -108,9 +118,19 @@ Result testResult(bool printPass = true) {
     return ResultCode_t::INVALID_FUNCTION;
   }
 
+  Result codeCopy = testResult;
+  if (codeCopy.getReferenceCount() && *codeCopy.getReferenceCount() == 1 &&
+      codeCopy == ResultCode_t::CRC) {
+    if (printPass)
+      std::cout << "[PASS] Reference count is 1 after copying code only\n";
+  } else {
+    std::cout << "[FAIL] Reference count is not 1 after copying code only\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
   std::stringstream string;
   string << testResult;
-  if (string.str().compare("[0x07] Data error (cyclic redundency check)") ==
+  if (string.str().compare("[0x07] Data error (cyclic redundancy check)") ==
       0) {
     if (printPass) {
       std::cout << "####\n" << testResult << "\n####\n";
@@ -156,6 +176,64 @@ Result testResult(bool printPass = true) {
     return ResultCode_t::INVALID_FUNCTION;
   }
 
+  Result chained = testRecursion(1000);
+  if (chained.getReferenceCount() && *chained.getReferenceCount() == 1 &&
+      strlen(chained.getMessage()) == strlen(testRecursion(999).getMessage()) +
+                                             strlen("\n  ->n=1000")) {
+    if (printPass)
+      std::cout << "[PASS] Message chain works with 1000 frames\n";
+  } else {
+    std::cout << "[FAIL] Message chain does not work with 1000 frames\n";
+    return ResultCode_t::INVALID_FUNCTION;
+  }
+
+  std::string temporary = "released";
+  int         line      = __LINE__ + 1;
+  Result      deferred  = ResultCode_t::TIMEOUT + FB_FORMAT("Base case") +
+                    FB_FORMAT("n={} {} {}{}", -8, temporary, 'c', 2.5) +
+                    "plain" + FB_FORMAT("{} {} {}", true, 7u);
+  temporary.assign("overwritten");
+  std::string expected = std::string(Results::MESSAGES[0x1B]) +
+                         "\n  ->Base case (main.cpp:" + std::to_string(line) +
+                         " testResult)\n  ->n=-8 released c2.5 (main.cpp:" +
+                         std::to_string(line + 1) +
+                         " testResult)\n  ->plain\n  ->true 7 {} (main.cpp:" +
+                         std::to_string(line + 2) + " testResult)";
+  if (expected == deferred.getMessage()) {
+    if (printPass)
+      std::cout << "[PASS] Deferred messages format when requested\n";
+  } else {
+    std::cout << "####\n" << deferred << "\n####\n";
+    std::cout << "[FAIL] Deferred messages do not format when requested\n";
+    return ResultCode_t::INVALID_FUNCTION;
+  }
+
+  // The formatted message is freed at its formatted length, not its strlen
+  size_t inUseBefore = Result::getMemoryStatistics().inUse;
+  {
+    std::string embedded = std::string(1, '\0') + std::string(200, 'x');
+    Result      nul      = ResultCode_t::TIMEOUT + FB_FORMAT("{}", embedded);
+    nul.getMessage();
+  }
+  if (Result::getMemoryStatistics().inUse == inUseBefore) {
+    if (printPass)
+      std::cout << "[PASS] Deferred messages holding '\\0' are released\n";
+  } else {
+    std::cout << "[FAIL] Deferred messages holding '\\0' are not released\n";
+    return ResultCode_t::INVALID_FUNCTION;
+  }
+
+  Result moved = std::move(chained);
+  if (moved.getReferenceCount() && *moved.getReferenceCount() == 1 &&
+      moved == ResultCode_t::BUFFER_OVERFLOW &&
+      strcmp(chained.getMessage(), Results::MESSAGES[0x11]) == 0) {
+    if (printPass)
+      std::cout << "[PASS] Move constructor takes the message\n";
+  } else {
+    std::cout << "[FAIL] Move constructor does not take the message\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
   if (!externCFunction()) {
     if (printPass) {
       std::cout << "[PASS] externCFunction works\n";
@@ -191,6 +269,34 @@ Result testResult(bool printPass = true) {
   return ResultCode_t::SUCCESS;
 }
 
+/**
+ * @brief Dispatch a text command by switching on its hash
+ *
+ * @param command to run
+ * @param value to operate on
+ * @return Result BAD_COMMAND if the command is not recognized
+ */
+Result runCommand(const std::string & command, int & value) {
+  static_assert(
+      hashesAreUnique({"increment"_hash, "decrement"_hash, "reset"_hash}),
+      "Command hashes collide");
+  Hash hash;
+  hash.add(command);
+  switch (hash.get()) {
+    case "increment"_hash:
+      ++value;
+      return ResultCode_t::SUCCESS;
+    case "decrement"_hash:
+      --value;
+      return ResultCode_t::SUCCESS;
+    case "reset"_hash:
+      value = 0;
+      return ResultCode_t::SUCCESS;
+    default:
+      return ResultCode_t::BAD_COMMAND + command.c_str();
+  }
+}
+
 /**
  * @brief Test the hash class
  *
@@ -311,21 +417,1561 @@ Result testHash(bool printPass = true) {
     return ResultCode_t::UNKNOWN_HASH;
   }
 
+  std::string bytes;
+  for (int i = 0; i < 1000; ++i)
+    bytes.push_back(static_cast<char>(i * 7));
+  Hash bulk;
+  Hash single;
+  bulk.add(bytes.c_str(), bytes.length());
+  for (char c : bytes)
+    single.add(c);
+  if (bulk.get() == single.get() && bulk.getString() == bytes) {
+    if (printPass)
+      std::cout << "[PASS] Bulk add matches single character add\n";
+  } else {
+    std::cout << "[FAIL] Bulk add does not match single character add\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  std::vector<std::string> keys;
+  uint32_t                 seed = 1;
+  for (int i = 0; i < 1007; ++i) {
+    std::string key;
+    for (int j = i % 41; j > 0; --j) {
+      seed = seed * 1103515245 + 12345;
+      key.push_back(static_cast<char>(seed >> 16));
+    }
+    keys.push_back(key);
+  }
+  std::vector<HashValue_t> hashes(keys.size());
+  Hash::calculateHashes(keys.data(), keys.size(), hashes.data());
+  bool batchMatches = true;
+  for (size_t i = 0; i < keys.size(); ++i)
+    batchMatches = batchMatches && hashes[i] == Hash::calculateHash(keys[i]);
+  if (batchMatches) {
+    if (printPass)
+      std::cout << "[PASS] Calculate hashes of a batch works\n";
+  } else {
+    std::cout << "[FAIL] Calculate hashes of a batch does not work\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  Hash moved(std::move(hash3));
+  if (moved.get() == hash.get() && moved.getReferenceCount() &&
+      *moved.getReferenceCount() == 1 && hash3.getString().empty()) {
+    if (printPass)
+      std::cout << "[PASS] Move constructor takes the string\n";
+  } else {
+    std::cout << "[FAIL] Move constructor does not take the string\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  hash3 = std::move(moved);
+  hash3.add('E');
+  if (hash3.getString().compare("!Hello world!E") == 0) {
+    if (printPass)
+      std::cout << "[PASS] Move assignment takes the string\n";
+  } else {
+    std::cout << "[FAIL] Move assignment does not take the string\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  static_assert("!Hello world!"_hash == Hash::calculateHash("!Hello world!"),
+      "Literal hash does not match calculateHash");
+  static_assert(!hashesAreUnique({"a"_hash, "b"_hash, "a"_hash}),
+      "Collision not detected");
+  if ("!Hello world!"_hash == hash.get() && ""_hash == Hash().get()) {
+    if (printPass)
+      std::cout << "[PASS] Literal hash matches Hash\n";
+  } else {
+    std::cout << "[FAIL] Literal hash does not match Hash\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  int    value   = 0;
+  Result command = runCommand("increment", value);
+  command        = command ? runCommand("increment", value) : command;
+  command        = command ? runCommand("decrement", value) : command;
+  Result unknown = runCommand("explode", value);
+  if (command && value == 1 &&
+      unknown.getCode() == ResultCode_t::BAD_COMMAND &&
+      strstr(unknown.getMessage(), "explode") != nullptr) {
+    if (printPass)
+      std::cout << "[PASS] Switch on hash dispatches commands\n";
+  } else {
+    std::cout << "[FAIL] Switch on hash does not dispatch commands\n";
+    return ResultCode_t::BAD_COMMAND;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the lite hash class
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testLiteHash(bool printPass = true) {
+  LiteHash liteHash;
+  if (liteHash.get() == 0xFFE40008 && sizeof(LiteHash) <= 8) {
+    if (printPass)
+      std::cout << "[PASS] Lite hash is small and initializes empty\n";
+  } else {
+    std::cout << "[FAIL] Lite hash is not small or does not initialize "
+                 "empty\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  std::string test = "!Hello world!\xE2\x82\xAC\x80"
+                     "EXTRASPACES";
+  Hash        hash;
+  hash.add(test);
+  liteHash.add(test);
+  if (liteHash.get() == hash.get() &&
+      liteHash.get() == Hash::calculateHash(test)) {
+    if (printPass)
+      std::cout << "[PASS] Lite hash matches Hash\n";
+  } else {
+    std::cout << "[FAIL] Lite hash does not match Hash\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  LiteHash liteHash2;
+  Hash     hash2;
+  size_t   liteLength = liteHash2.add(test.c_str(), test.length(), 'E');
+  size_t   length     = hash2.add(test.c_str(), test.length(), 'E');
+  if (liteHash2.get() == hash2.get() && liteLength == length) {
+    if (printPass)
+      std::cout << "[PASS] Lite hash with termination character works\n";
+  } else {
+    std::cout
+        << "[FAIL] Lite hash with termination character does not work\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
   return ResultCode_t::SUCCESS;
 }
 
-int main() {
-  std::cout << "Testing FruitBowl\n";
-  Result result = testResult(true);
-  if (!result)
-    std::cout << "[FAIL] *** Result class does not pass ***\n";
+/**
+ * @brief Test the perfect hash table
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testPerfectHash(bool printPass = true) {
+  static constexpr const char * KEYS[] = {"get", "set", "delete", "list",
+      "help", "quit", "", "a", "b", "ab", "ba", "increment", "decrement",
+      "reset", "status", "version", "name", "value", "type", "id"};
+  static constexpr auto TABLE = makePerfectHash(KEYS);
+  static_assert(TABLE.isValid(), "Perfect hash could not place the keys");
+  static_assert(!makePerfectHash({"same", "other", "same"}).isValid(),
+      "Duplicate keys not detected");
 
-  // while (true)
-  //   result = testResult(false);
+  bool allFound = true;
+  for (size_t i = 0; i < TABLE.size(); ++i) {
+    size_t index = TABLE.size();
+    allFound     = allFound && TABLE.find(KEYS[i], strlen(KEYS[i]), index) &&
+               index == i;
+  }
+  if (allFound) {
+    if (printPass)
+      std::cout << "[PASS] Perfect hash finds every key\n";
+  } else {
+    std::cout << "[FAIL] Perfect hash does not find every key\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
 
-  result = testHash(true);
-  if (!result)
-    std::cout << "[FAIL] *** Hash class does not pass ***\n";
+  size_t index = 0;
+  Hash   hash;
+  hash.add("reset");
+  Result miss  = TABLE.find(std::string("gets"), index);
+  Result miss2 = TABLE.find("ge", 2, index);
+  if (miss.getCode() == ResultCode_t::UNKNOWN_HASH &&
+      miss2.getCode() == ResultCode_t::UNKNOWN_HASH &&
+      TABLE.find(hash, index) && index == 13) {
+    if (printPass)
+      std::cout << "[PASS] Perfect hash rejects unknown keys\n";
+  } else {
+    std::cout << "[FAIL] Perfect hash does not reject unknown keys\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the hash map
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testHashMap(bool printPass = true) {
+  HashMap<int> map;
+  const int    count = 10000;
+  for (int i = 0; i < count; ++i)
+    map.set("key" + std::to_string(i), i);
+  bool allFound = map.size() == count;
+  for (int i = 0; i < count; ++i) {
+    const int * value = map.find("key" + std::to_string(i));
+    allFound          = allFound && value != nullptr && *value == i;
+  }
+  if (allFound && map.find("key") == nullptr &&
+      map.find(std::string("key10000")) == nullptr) {
+    if (printPass)
+      std::cout << "[PASS] Hash map finds every key\n";
+  } else {
+    std::cout << "[FAIL] Hash map does not find every key\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  Hash hash;
+  hash.add("key42");
+  map.set(hash, -42);
+  if (map.size() == count && *map.find(hash) == -42 &&
+      *map.find("key42", 5) == -42) {
+    if (printPass)
+      std::cout << "[PASS] Hash map accepts Hash keys\n";
+  } else {
+    std::cout << "[FAIL] Hash map does not accept Hash keys\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  bool removed = true;
+  for (int i = 0; i < count; i += 2)
+    removed = removed && map.remove("key" + std::to_string(i));
+  Result missing = map.remove(hash);
+  for (int i = 1; i < count; i += 2) {
+    const int * value = map.find("key" + std::to_string(i));
+    removed           = removed && value != nullptr && *value == i;
+  }
+  int sum = 0;
+  map.forEach([&](const std::string &, int & value) { sum += value; });
+  if (removed && map.size() == count / 2 &&
+      missing.getCode() == ResultCode_t::UNKNOWN_HASH &&
+      sum == (count / 2) * (count / 2)) {
+    if (printPass)
+      std::cout << "[PASS] Hash map removes keys\n";
+  } else {
+    std::cout << "[FAIL] Hash map does not remove keys\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  // A key set with a seeded Hash is the same key as its string
+  HashMap<int> seeded;
+  Hash         seededKey(5);
+  seededKey.add("x");
+  seeded.set("y", 1, 1);
+  seeded.set(seededKey, 2);
+  removed = seeded.find("x", 1) != nullptr && *seeded.find("x", 1) == 2;
+  seeded.set(std::string("x"), 3);
+  removed = removed && seeded.size() == 2 && seeded.remove("y", 1) &&
+            seeded.size() == 1 && seeded.find(seededKey) != nullptr &&
+            *seeded.find(seededKey) == 3 && seeded.remove(seededKey) &&
+            seeded.size() == 0;
+  if (removed) {
+    if (printPass)
+      std::cout << "[PASS] Hash map finds seeded Hash keys by string\n";
+  } else {
+    std::cout << "[FAIL] Hash map does not find seeded Hash keys by "
+                 "string\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  HashMap<std::string> strings;
+  strings.set("a", "first");
+  strings.set("a", "second");
+  HashMap<std::string> moved(std::move(strings));
+  if (moved.size() == 1 && *moved.find("a", 1) == "second" &&
+      strings.size() == 0 && strings.find("a", 1) == nullptr) {
+    if (printPass)
+      std::cout << "[PASS] Hash map replaces values and moves\n";
+  } else {
+    std::cout << "[FAIL] Hash map does not replace values or move\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the intern table
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testInternTable(bool printPass = true) {
+  InternTable table;
+  Hash        owned;
+  Hash        seeded(5);
+  owned.add("identifier");
+  seeded.add("identifier");
+  Hash first  = table.intern("identifier", 10);
+  Hash second = table.intern(std::string("identifier"));
+  Hash third  = table.intern(owned);
+  Hash fourth = table.intern(seeded);
+  Hash other  = table.intern("other", 5);
+  if (first.isInterned() && !owned.isInterned() &&
+      &first.getString() == &fourth.getString() &&
+      fourth.get() == first.get() &&
+      first.getReferenceCount() == nullptr &&
+      &first.getString() == &second.getString() &&
+      &first.getString() == &third.getString() &&
+      &first.getString() != &other.getString() &&
+      first.get() == owned.get() && table.size() == 2) {
+    if (printPass)
+      std::cout << "[PASS] Intern table stores each string once\n";
+  } else {
+    std::cout << "[FAIL] Intern table does not store each string once\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  Hash copy = first;
+  copy.add("Suffix");
+  owned.add("Suffix");
+  if (copy.get() == owned.get() && !copy.isInterned() &&
+      first.getString() == "identifier" && second.isInterned()) {
+    if (printPass)
+      std::cout << "[PASS] Adding to an interned hash copies the string\n";
+  } else {
+    std::cout << "[FAIL] Adding to an interned hash modifies the string\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  Hash   found;
+  Hash   foundByValue;
+  Result missing = table.find("missing", 7, found);
+  if (table.find("other", 5, found) &&
+      &found.getString() == &other.getString() &&
+      table.find(first.get(), foundByValue) &&
+      &foundByValue.getString() == &first.getString() &&
+      missing.getCode() == ResultCode_t::UNKNOWN_HASH &&
+      table.find(Hash::calculateHash("missing"), found).getCode() ==
+          ResultCode_t::UNKNOWN_HASH &&
+      table.size() == 2) {
+    if (printPass)
+      std::cout << "[PASS] Intern table finds strings and hashes\n";
+  } else {
+    std::cout << "[FAIL] Intern table does not find strings and hashes\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+#ifndef FRUIT_BOWL_NO_THREADS
+  const int                               threadCount = 4;
+  const int                               count       = 20000;
+  std::vector<std::vector<const void *> > addresses(threadCount);
+  std::vector<std::thread>                threads;
+  for (int t = 0; t < threadCount; ++t) {
+    threads.push_back(std::thread([&, t]() {
+      for (int i = 0; i < count; ++i) {
+        int  n    = (i * 7 + t * 13) % count;
+        Hash hash = table.intern("key" + std::to_string(n));
+        if (static_cast<int>(addresses[t].size()) <= n)
+          addresses[t].resize(count);
+        addresses[t][n] = &hash.getString();
+      }
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  bool consistent = table.size() == count + 2;
+  for (int t = 1; t < threadCount; ++t)
+    consistent = consistent && addresses[t] == addresses[0];
+  if (consistent) {
+    if (printPass)
+      std::cout << "[PASS] Intern table is consistent across threads\n";
+  } else {
+    std::cout << "[FAIL] Intern table is not consistent across threads\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Split a string one character at a time
+ *
+ * @param input to split
+ * @param delimiters characters
+ * @return std::vector<std::string> tokens, including the characters after
+ * the final delimiter if there are any
+ */
+std::vector<std::string> splitReference(
+    const std::string & input, const std::string & delimiters) {
+  std::vector<std::string> tokens;
+  std::string              token;
+  for (char c : input) {
+    if (delimiters.find(c) != std::string::npos) {
+      tokens.push_back(token);
+      token.clear();
+    } else {
+      token.push_back(c);
+    }
+  }
+  if (!token.empty())
+    tokens.push_back(token);
+  return tokens;
+}
+
+/**
+ * @brief Test the tokenizer
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testTokenizer(bool printPass = true) {
+  const std::string sets[] = {",", ",\n", std::string(",;\t \0", 5),
+      ",;:|\t\n\r /\\-"};
+  std::string input;
+  uint32_t    state   = 1;
+  bool        matches = true;
+  for (size_t length = 0; length < 5000; length += 1 + length / 8) {
+    input.resize(length);
+    for (size_t i = 0; i < length; ++i) {
+      state    = state * 1103515245 + 12345;
+      input[i] = "abc,;:|\t\n\r /\\-\0\x80"[(state >> 16) % 17];
+    }
+    for (const std::string & delimiters : sets) {
+      Tokenizer                     tokenizer(delimiters);
+      std::vector<Tokenizer::Token> tokens;
+      tokenizer.tokenize(input.c_str(), input.length(), tokens);
+      std::vector<std::string> expected = splitReference(input, delimiters);
+      matches = matches && tokens.size() == expected.size();
+      for (size_t i = 0; i < tokens.size() && matches; ++i) {
+        matches = std::string(tokens[i].c, tokens[i].length) == expected[i] &&
+                  tokens[i].hash == Hash::calculateHash(expected[i]);
+      }
+    }
+  }
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Tokenizer splits and hashes tokens\n";
+  } else {
+    std::cout << "[FAIL] Tokenizer does not split and hash tokens\n";
+    return ResultCode_t::INVALID_DATA;
+  }
+
+  TokenizerWy              tokenizer(",\n");
+  std::string              stream = "first,second\nthird,fourth,fifth";
+  std::vector<std::string> streamed;
+  std::string              carry;
+  bool                     hashed = true;
+  auto                     collect = [&](const TokenizerWy::Token & token) {
+    streamed.push_back(std::string(token.c, token.length));
+    hashed = hashed && token.hash == WyHash::calculate(token.c, token.length);
+  };
+  for (size_t i = 0; i < stream.length(); i += 4) {
+    carry += stream.substr(i, 4);
+    bool   last     = i + 4 >= stream.length();
+    size_t consumed = tokenizer.tokenize(
+        carry.c_str(), carry.length(), collect, last);
+    carry.erase(0, consumed);
+  }
+  if (hashed && carry.empty() &&
+      streamed == splitReference(stream, ",\n")) {
+    if (printPass)
+      std::cout << "[PASS] Tokenizer carries tokens across arrays\n";
+  } else {
+    std::cout << "[FAIL] Tokenizer does not carry tokens across arrays\n";
+    return ResultCode_t::INVALID_DATA;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test UTF-8 validation
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testUTF8(bool printPass = true) {
+  // Invalid sequences and the offset of their first invalid character
+  const std::pair<std::string, size_t> invalid[] = {{"\x80", 0}, {"\xBF", 0},
+      {"\xC0\x80", 0}, {"\xC1\xBF", 0}, {"\xC2", 0}, {"\xC2\x41", 0},
+      {"\xE0\x80\x80", 0}, {"\xE0\x9F\xBF", 0}, {"\xED\xA0\x80", 0},
+      {"\xED\xBF\xBF", 0}, {"\xE2\x82", 0}, {"\xE2\x82\x41", 0},
+      {"\xF0\x80\x80\x80", 0}, {"\xF0\x8F\xBF\xBF", 0},
+      {"\xF4\x90\x80\x80", 0}, {"\xF5\x80\x80\x80", 0}, {"\xFF", 0},
+      {"\xF0\x9F\x98", 0}, {"\xF0\x9F\x98\x80\x80", 4}};
+  const char * valid[] = {"\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80",
+      "\xE2\x82\xAC", "\xED\x9F\xBF", "\xEE\x80\x80", "\xF0\x90\x80\x80",
+      "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF"};
+  std::vector<size_t> boundaries;
+  std::string         text;
+  uint32_t            state = 1;
+  while (text.length() < 9000) {
+    boundaries.push_back(text.length());
+    state = state * 1103515245 + 12345;
+    text += (state >> 16) % 3 == 0 ? valid[(state >> 20) % 9] : "b";
+  }
+
+  // Insert at every character boundary near vector blocks and windows, and
+  // into ASCII where a truncated sequence is followed by an ASCII block
+  bool matches = UTF8::validate(text) && UTF8::validate("", 0);
+  for (const std::pair<std::string, size_t> & sequence : invalid) {
+    for (size_t offset = 0; offset < 200; ++offset) {
+      std::string input(300, 'a');
+      input.insert(offset, sequence.first);
+      matches = matches && UTF8::findInvalid(input.c_str(), input.length()) ==
+                               offset + sequence.second;
+    }
+    for (size_t offset : boundaries) {
+      if (offset > 300 && (offset < 4000 || offset > 4200))
+        continue;
+      std::string input = text;
+      input.insert(offset, sequence.first);
+      size_t expected = offset + sequence.second;
+      size_t found    = UTF8::findInvalid(input.c_str(), input.length());
+      HashValue_t hash   = 0;
+      Result      result = UTF8::validateAndHash(
+          input.c_str(), input.length(), hash);
+      matches = matches && found == expected &&
+                result == ResultCode_t::INVALID_UTF8 && hash == 0 &&
+                std::string(result.getMessage())
+                        .find(std::to_string(expected)) != std::string::npos;
+    }
+  }
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] UTF8 finds the first invalid sequence\n";
+  } else {
+    std::cout << "[FAIL] UTF8 does not find the first invalid sequence\n";
+    return ResultCode_t::INVALID_UTF8;
+  }
+
+  HashValue_t hash     = 0;
+  uint64_t    hashWy   = 0;
+  Result      result   = UTF8::validateAndHash(text.c_str(), text.length(), hash);
+  Result      resultWy = UTF8::validateAndHash<WyHash>(
+      text.c_str(), text.length(), hashWy);
+  if (result && resultWy && hash == Hash::calculateHash(text) &&
+      hashWy == WyHash::calculate(text.c_str(), text.length())) {
+    if (printPass)
+      std::cout << "[PASS] UTF8 validates and hashes\n";
+  } else {
+    std::cout << "[FAIL] UTF8 does not validate and hash\n";
+    return ResultCode_t::INVALID_UTF8;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the CRC32C checksum
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testCRC32C(bool printPass = true) {
+  // RFC 3720 B.4 and the standard check value
+  char zeros[32]       = {};
+  char ones[32]        = {};
+  char incrementing[32] = {};
+  for (int i = 0; i < 32; ++i) {
+    ones[i]         = static_cast<char>(0xFF);
+    incrementing[i] = static_cast<char>(i);
+  }
+  if (CRC32C::calculate("", 0) == 0 &&
+      CRC32C::calculate("123456789", 9) == 0xE3069283 &&
+      CRC32C::calculate(zeros, 32) == 0x8A9136AA &&
+      CRC32C::calculate(ones, 32) == 0x62A8AB43 &&
+      CRC32C::calculate(incrementing, 32) == 0x46DD794E &&
+      CRC32C::calculateSoftware("123456789", 9) == 0xE3069283 &&
+      CRC32C::calculateSoftware(incrementing, 32) == 0x46DD794E) {
+    if (printPass)
+      std::cout << "[PASS] CRC32C matches reference values\n";
+  } else {
+    std::cout << "[FAIL] CRC32C does not match reference values\n";
+    return ResultCode_t::CRC;
+  }
+
+  // Long enough for every stream length of the hardware calculation
+  std::vector<char> data(100000);
+  uint32_t          state = 1;
+  for (char & c : data) {
+    state = state * 1103515245 + 12345;
+    c     = static_cast<char>(state >> 16);
+  }
+  bool matches = true;
+  for (size_t length = 0; length <= data.size();
+       length += 1 + length / 4) {
+    uint32_t crc = CRC32C::calculate(data.data(), length);
+    matches      = matches &&
+              crc == CRC32C::calculateSoftware(data.data(), length);
+    for (size_t split = 0; split <= length; split += 1 + split / 2) {
+      CRC32C   streamed;
+      uint32_t crcA = CRC32C::calculate(data.data(), split);
+      uint32_t crcB = CRC32C::calculate(data.data() + split, length - split);
+      streamed.add(data.data(), split);
+      streamed.add(data.data() + split, length - split);
+      matches = matches && streamed.get() == crc &&
+                CRC32C::combine(crcA, crcB, length - split) == crc;
+    }
+  }
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] CRC32C streams and combines chunks\n";
+  } else {
+    std::cout << "[FAIL] CRC32C does not stream and combine chunks\n";
+    return ResultCode_t::CRC;
+  }
+
+  CRC32C crc;
+  crc.add("123456789");
+  Result match    = crc.check(0xE3069283);
+  Result mismatch = crc.check(0xE3069284);
+  if (match && mismatch == ResultCode_t::CRC &&
+      strstr(mismatch.getMessage(), "0xE3069284") != nullptr) {
+    if (printPass)
+      std::cout << "[PASS] CRC32C check reports mismatches\n";
+  } else {
+    std::cout << "[FAIL] CRC32C check does not report mismatches\n";
+    return ResultCode_t::CRC;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test hashing files
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testFile(bool printPass = true) {
+  const std::string path = "FruitBowl-Test-File.bin";
+  const size_t      sizes[] = {0, 1, 1000, File::MAP_MINIMUM + 12345};
+  bool              matches = true;
+  for (size_t size : sizes) {
+    std::string contents(size, '\0');
+    uint32_t    state = static_cast<uint32_t>(size);
+    for (char & c : contents) {
+      state = state * 1103515245 + 12345;
+      c     = static_cast<char>(state >> 16);
+    }
+    std::ofstream(path, std::ios::binary) << contents;
+
+    for (File::Access_t access :
+        {File::Access_t::AUTO, File::Access_t::MAP, File::Access_t::READ}) {
+      HashValue_t hash   = 0;
+      uint64_t    hashWy = 0;
+      uint32_t    crc    = 0;
+      matches = matches && File::hash(path, hash, access) &&
+                File::hash<WyHash>(path, hashWy, access) &&
+                File::checksum(path, crc, access) &&
+                hash == Hash::calculateHash(contents) &&
+                hashWy == WyHash::calculate(contents.c_str(), size) &&
+                crc == CRC32C::calculate(contents.c_str(), size);
+    }
+  }
+  std::remove(path.c_str());
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] File hashes match the contents' hashes\n";
+  } else {
+    std::cout << "[FAIL] File hashes do not match the contents' hashes\n";
+    return ResultCode_t::READ_FAULT;
+  }
+
+  HashValue_t hash   = 1;
+  Result      result = File::hash(path, hash);
+  if (result == ResultCode_t::OPEN_FAILED && hash == 1) {
+    if (printPass)
+      std::cout << "[PASS] File reports missing files\n";
+  } else {
+    std::cout << "[FAIL] File does not report missing files\n";
+    return ResultCode_t::OPEN_FAILED;
+  }
+
+  // A file shrinking between mapped windows ends the read rather than faulting
+  {
+    std::ofstream sparse(path, std::ios::binary);
+    sparse.seekp(static_cast<std::streamoff>(File::MAP_WINDOW * 2 - 1));
+    sparse.put('\0');
+  }
+  struct Shrink {
+    const std::string * path;
+    size_t              chunks;
+  };
+  Shrink shrink = {&path, 0};
+  result        = File::read(
+      path,
+      [](void * context, const char *, size_t) {
+        Shrink * state = static_cast<Shrink *>(context);
+        if (state->chunks++ == 0)
+          std::ofstream(*state->path, std::ios::binary);
+      },
+      &shrink, File::Access_t::MAP);
+  std::remove(path.c_str());
+  if (result == ResultCode_t::END_OF_FILE && shrink.chunks == 1) {
+    if (printPass)
+      std::cout << "[PASS] File reports files shrinking while mapped\n";
+  } else {
+    std::cout << "[FAIL] File does not report files shrinking while mapped\n";
+    return ResultCode_t::END_OF_FILE;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test content defined chunking
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testChunker(bool printPass = true) {
+  std::vector<char> data(1 << 20);
+  uint32_t          state = 1;
+  for (char & c : data) {
+    state = state * 1103515245 + 12345;
+    c     = static_cast<char>(state >> 16);
+  }
+
+  // Chunks cover the stream within the size limits wherever the stream is
+  // split into arrays
+  ChunkerWy                       chunker(1024, 4096, 16384);
+  std::vector<ChunkerWy::Chunk>   chunks;
+  chunker.add(data.data(), data.size(), chunks);
+  chunker.finish(chunks);
+  bool     matches = chunks.size() > 100;
+  uint64_t offset  = 0;
+  for (size_t i = 0; i < chunks.size() && matches; ++i) {
+    const ChunkerWy::Chunk & chunk = chunks[i];
+    matches = chunk.offset == offset && chunk.length <= 16384 &&
+              (chunk.length >= 1024 || i + 1 == chunks.size()) &&
+              chunk.hash == WyHash::calculate(
+                                data.data() + chunk.offset, chunk.length);
+    offset += chunk.length;
+  }
+  matches = matches && offset == data.size();
+  for (size_t step : {1, 7, 1000, 5000}) {
+    std::vector<ChunkerWy::Chunk> streamed;
+    for (size_t i = 0; i < data.size(); i += step) {
+      size_t n = data.size() - i < step ? data.size() - i : step;
+      chunker.add(data.data() + i, n, streamed);
+    }
+    chunker.finish(streamed);
+    matches = matches && streamed.size() == chunks.size();
+    for (size_t i = 0; i < streamed.size() && matches; ++i)
+      matches = streamed[i].length == chunks[i].length &&
+                streamed[i].hash == chunks[i].hash;
+  }
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Chunker splits streams into hashed chunks\n";
+  } else {
+    std::cout << "[FAIL] Chunker does not split streams into hashed chunks\n";
+    return ResultCode_t::INVALID_DATA;
+  }
+
+  // Inserting characters only changes the chunks around the insertion
+  std::vector<char> edited(data);
+  edited.insert(edited.begin() + 300000, 100, 'x');
+  Chunker                     chunkerJenkins;
+  std::vector<Chunker::Chunk> original;
+  std::vector<Chunker::Chunk> modified;
+  chunkerJenkins.add(data.data(), data.size(), original);
+  chunkerJenkins.finish(original);
+  chunkerJenkins.add(edited.data(), edited.size(), modified);
+  chunkerJenkins.finish(modified);
+  size_t shared = 0;
+  for (const Chunker::Chunk & chunk : modified) {
+    for (const Chunker::Chunk & other : original) {
+      if (chunk.hash == other.hash && chunk.length == other.length) {
+        ++shared;
+        break;
+      }
+    }
+  }
+  if (shared + 3 >= modified.size() && modified.size() > 50) {
+    if (printPass)
+      std::cout << "[PASS] Chunker boundaries follow the content\n";
+  } else {
+    std::cout << "[FAIL] Chunker boundaries do not follow the content\n";
+    return ResultCode_t::INVALID_DATA;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the Bloom filter
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testBloomFilter(bool printPass = true) {
+  const size_t             count = 10000;
+  BloomFilter              filter(count, 10);
+  std::vector<HashValue_t> hashes(count);
+  std::vector<HashValue_t> misses(count);
+  for (size_t i = 0; i < count; ++i) {
+    hashes[i] = Hash::calculateHash("key" + std::to_string(i));
+    misses[i] = Hash::calculateHash("miss" + std::to_string(i));
+  }
+  filter.add(hashes.data(), count / 2);
+  for (size_t i = count / 2; i < count; ++i)
+    filter.add("key" + std::to_string(i));
+
+  std::unique_ptr<bool[]> results(new bool[count]);
+  Hash                    key;
+  key.add("key1");
+  bool matches = filter.contains(hashes.data(), count, results.get()) ==
+                     count &&
+                 filter.contains(key) && filter.contains("key9999");
+  for (size_t i = 0; i < count && matches; ++i)
+    matches = filter.contains(hashes[i]);
+  size_t falsePositives = filter.contains(misses.data(), count, results.get());
+  for (size_t i = 0; i < count && matches; ++i)
+    matches = results[i] == filter.contains(misses[i]);
+  if (matches && falsePositives < count / 50) {
+    if (printPass)
+      std::cout << "[PASS] Bloom filter contains every key, "
+                << falsePositives << " false positives of " << count << "\n";
+  } else {
+    std::cout << "[FAIL] Bloom filter does not contain every key, "
+              << falsePositives << " false positives of " << count << "\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  // The vector path (used for batches when available) matches the scalar
+  // path for every number of probes and every rotation of a block
+  for (size_t bitsPerKey = 1; bitsPerKey <= 24 && matches; ++bitsPerKey) {
+    BloomFilter small(count / 8, bitsPerKey);
+    small.add(hashes.data(), count / 8);
+    size_t found = small.contains(hashes.data(), count, results.get());
+    for (size_t i = 0; i < count && matches; ++i)
+      matches = results[i] == small.contains(hashes[i]) &&
+                (i >= count / 8 || results[i]);
+    matches = matches && found != count;
+  }
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Bloom filter batches match single keys\n";
+  } else {
+    std::cout << "[FAIL] Bloom filter batches do not match single keys\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  std::string image;
+  filter.save(image);
+  BloomFilter loaded;
+  matches = loaded.load(image.data(), image.size()) &&
+            loaded.getProbes() == filter.getProbes() &&
+            loaded.getBits() == filter.getBits() &&
+            loaded.contains(hashes.data(), count, results.get()) == count &&
+            loaded.contains(misses.data(), count, results.get()) ==
+                falsePositives;
+  image[image.size() / 2] ^= 1;
+  matches = matches &&
+            loaded.load(image.data(), image.size()) == ResultCode_t::CRC &&
+            loaded.load(image.data(), image.size() - 1) ==
+                ResultCode_t::INVALID_DATA &&
+            loaded.load(image.data(), 10) == ResultCode_t::INVALID_DATA;
+  // More blocks than a filter holds is rejected from the header alone
+  if (sizeof(size_t) > 4) {
+    std::string oversized = image.substr(0, 32);
+    uint64_t    blocks    = (static_cast<uint64_t>(1) << 32) + 1;
+    memcpy(&oversized[16], &blocks, sizeof(blocks));
+    matches = matches &&
+              loaded.load(oversized.data(),
+                  static_cast<size_t>(32 + blocks * 64)) ==
+                  ResultCode_t::INVALID_DATA;
+  }
+  image[0] = 'X';
+  matches  = matches &&
+            loaded.load(image.data(), image.size()) ==
+                ResultCode_t::INVALID_DATA &&
+            loaded.contains(hashes.data(), count, results.get()) == count;
+  loaded.clear();
+  matches = matches && !loaded.contains(hashes[0]);
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Bloom filter saves and loads\n";
+  } else {
+    std::cout << "[FAIL] Bloom filter does not save and load\n";
+    return ResultCode_t::CRC;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the persistent hash index
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testHashIndex(bool printPass = true) {
+  const std::string path = "FruitBowl-Test-Index.bin";
+  HashIndexBuilder  builder;
+  for (size_t i = 0; i < 1000; ++i)
+    builder.add("key" + std::to_string(i), "payload" + std::to_string(i * 7));
+  builder.add("key5", "replaced");
+  builder.add("", "empty key");
+  Result result = builder.write(path);
+
+  HashIndex index;
+  result        = result ? index.open(path) : result;
+  bool matches  = result && index.size() == 1001;
+  for (size_t i = 0; i < 1000 && matches; ++i) {
+    std::string key      = "key" + std::to_string(i);
+    std::string expected =
+        i == 5 ? "replaced" : "payload" + std::to_string(i * 7);
+    size_t       length  = 0;
+    const char * payload = index.find(key, length);
+    matches = payload != nullptr && std::string(payload, length) == expected;
+  }
+  size_t length = 0;
+  Hash   key;
+  Hash   seeded(5);
+  key.add("key999");
+  seeded.add("key998");
+  matches = matches && index.find("key1000", length) == nullptr &&
+            index.find(key, length) != nullptr &&
+            index.find(seeded, length) != nullptr &&
+            std::string(index.find(seeded, length), length) == "payload6986";
+  const char * payload = index.find("", 0, length);
+  matches = matches && payload != nullptr &&
+            std::string(payload, length) == "empty key";
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Hash index finds every key in place\n";
+  } else {
+    std::cout << "[FAIL] Hash index does not find every key in place\n";
+    std::remove(path.c_str());
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  // Flip a character of the header, the slots and a payload
+  std::string image;
+  builder.build(image);
+  std::vector<uint64_t> aligned(image.size() / 8 + 1);
+  char *                data = reinterpret_cast<char *>(aligned.data());
+  memcpy(data, image.data(), image.size());
+  HashIndex memory;
+  matches = !!memory.load(data, image.size());
+  data[20] ^= 1;
+  matches = matches && memory.load(data, image.size()) == ResultCode_t::CRC;
+  data[20] ^= 1;
+  data[100] ^= 1;
+  matches = matches && memory.load(data, image.size()) == ResultCode_t::CRC &&
+            memory.load(data, image.size(), false);
+  data[100] ^= 1;
+  data[image.size() - 1] ^= 1;
+  matches = matches && memory.load(data, image.size()) == ResultCode_t::CRC;
+  data[0] = 'X';
+  matches = matches &&
+            memory.load(data, image.size()) == ResultCode_t::INVALID_DATA &&
+            memory.load(data, 10) == ResultCode_t::INVALID_DATA &&
+            memory.size() == 0;
+  std::ofstream(path, std::ios::binary) << image.substr(0, image.size() / 2);
+  matches = matches && index.open(path) == ResultCode_t::INVALID_DATA;
+  std::remove(path.c_str());
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Hash index detects corruption\n";
+  } else {
+    std::cout << "[FAIL] Hash index does not detect corruption\n";
+    return ResultCode_t::CRC;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test streaming hashes split at every position match the one shot hash
+ *
+ * @tparam Algorithm to test
+ * @param data to hash
+ * @param maxLength hash every prefix up to this length
+ * @return true if every split matches
+ */
+template <class Algorithm>
+bool streamMatchesOneShot(const std::vector<char> & data, size_t maxLength) {
+  for (size_t length = 0; length <= maxLength; ++length) {
+    typename Algorithm::Value_t expected =
+        Algorithm::calculate(data.data(), length);
+    size_t split[] = {0, length / 3, length / 2, length};
+    BasicLiteHash<Algorithm> hash;
+    for (size_t i = 1; i < sizeof(split) / sizeof(split[0]); ++i)
+      hash.add(data.data() + split[i - 1], split[i] - split[i - 1]);
+    BasicLiteHash<Algorithm> perCharacter;
+    for (size_t i = 0; i < length; ++i)
+      perCharacter.add(data[i]);
+    if (hash.get() != expected || perCharacter.get() != expected)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Test the hash algorithm policies
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testHashAlgorithms(bool printPass = true) {
+  std::vector<char> data(1000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>((i * 7) & 0xFF);
+
+  const char * fox = "The quick brown fox jumps over the lazy dog";
+  if (XXH64::calculate("", 0) == 0xEF46DB3751D8E999 &&
+      XXH64::calculate("abc", 3) == 0x44BC2CF5AD770999 &&
+      XXH64::calculate(fox, strlen(fox)) == 0x0B242D361FDA71BC &&
+      XXH64::calculate(data.data(), data.size()) == 0x25275608A9CFC168) {
+    if (printPass)
+      std::cout << "[PASS] XXH64 matches reference values\n";
+  } else {
+    std::cout << "[FAIL] XXH64 does not match reference values\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  LiteHashXXH64 seeded(0x1234);
+  seeded.add(data.data(), data.size());
+  if (seeded.get() == 0x37459F4093BE6289) {
+    if (printPass)
+      std::cout << "[PASS] XXH64 with seed matches reference value\n";
+  } else {
+    std::cout << "[FAIL] XXH64 with seed does not match reference value\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  if (streamMatchesOneShot<Jenkins>(data, 300) &&
+      streamMatchesOneShot<XXH64>(data, 300) &&
+      streamMatchesOneShot<WyHash>(data, 300)) {
+    if (printPass)
+      std::cout << "[PASS] Streaming hashes match one shot hashes\n";
+  } else {
+    std::cout << "[FAIL] Streaming hashes do not match one shot hashes\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  HashWy    wy;
+  HashXXH64 xxh;
+  wy.add(fox);
+  xxh.add(fox);
+  if (WyHash::calculate("", 0) != WyHash::calculate("a", 1) &&
+      wy.get() == HashWy::calculateHash(fox, strlen(fox)) &&
+      xxh.get() == 0x0B242D361FDA71BC && xxh.getString() == fox &&
+      HashWy(1).get() != HashWy(2).get()) {
+    if (printPass)
+      std::cout << "[PASS] Hash with other algorithms works\n";
+  } else {
+    std::cout << "[FAIL] Hash with other algorithms does not work\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 100; ++i)
+    keys.push_back(std::string(data.data(), i));
+  std::vector<uint64_t> hashes(keys.size());
+  HashWy::calculateHashes(keys.data(), keys.size(), hashes.data());
+  bool batchMatches = true;
+  for (size_t i = 0; i < keys.size(); ++i)
+    batchMatches = batchMatches && hashes[i] == HashWy::calculateHash(keys[i]);
+  if (batchMatches) {
+    if (printPass)
+      std::cout << "[PASS] Batch hashing with other algorithms works\n";
+  } else {
+    std::cout << "[FAIL] Batch hashing with other algorithms does not work\n";
+    return ResultCode_t::UNKNOWN_HASH;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Value counting its live instances, copying throws when asked to
+ */
+struct Tracked {
+  static int live;
+  bool       throwOnCopy;
+
+  Tracked() : throwOnCopy(false) {
+    ++live;
+  }
+  Tracked(const Tracked & tracked) : throwOnCopy(tracked.throwOnCopy) {
+    if (throwOnCopy)
+      throw std::runtime_error("Copy failed");
+    ++live;
+  }
+  ~Tracked() {
+    --live;
+  }
+};
+
+int Tracked::live = 0;
+
+/**
+ * @brief Parse a decimal digit
+ *
+ * @param c character to parse
+ * @return Expected<int, ResultCode_t> digit or INVALID_PARAMETER
+ */
+static Expected<int, ResultCode_t> parseDigit(char c) {
+  if (c < '0' || c > '9')
+    return ResultCode_t::INVALID_PARAMETER;
+  return c - '0';
+}
+
+/**
+ * @brief Test the Expected class
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testExpected(bool printPass = true) {
+  static_assert(std::is_trivially_copyable<Expected<int, ResultCode_t>>::value,
+      "Expected of a trivial value and code is trivially copyable");
+  static_assert(sizeof(Expected<int, ResultCode_t>) <= 8,
+      "Expected of an int and code fits a register");
+
+  Expected<int, ResultCode_t> digit   = parseDigit('7');
+  Expected<int, ResultCode_t> invalid = parseDigit('x');
+  Expected<int>               message = invalid;
+  Expected<int>               traced  = Expected<int>(invalid) + "Not a digit";
+  bool matches = digit && digit.hasValue() && digit.getValue() == 7 &&
+                 !invalid &&
+                 invalid.getError() == ResultCode_t::INVALID_PARAMETER &&
+                 invalid.getValueOr(-1) == -1 && digit.getResult() &&
+                 !message &&
+                 message.getError() == ResultCode_t::INVALID_PARAMETER &&
+                 !traced &&
+                 strstr(traced.getError().getMessage(), "\n  ->Not a digit");
+
+  Expected<int> success = ResultCode_t::SUCCESS;
+  matches               = matches && !success &&
+            success.getError() == ResultCode_t::INVALID_STATE &&
+            Expected<int>(ResultCode_t::SUCCESS + "Not an error")
+                    .getError() == ResultCode_t::INVALID_STATE;
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Expected holds a value or an error\n";
+  } else {
+    std::cout << "[FAIL] Expected does not hold a value or an error\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  auto half = [](int value) -> Expected<int, ResultCode_t> {
+    if (value % 2 != 0)
+      return ResultCode_t::INVALID_DATA;
+    return value / 2;
+  };
+  auto square = [](int value) { return value * value; };
+  matches     = parseDigit('8').andThen(half).map(square).getValue() == 16 &&
+            parseDigit('7').andThen(half).getError() ==
+                ResultCode_t::INVALID_DATA &&
+            parseDigit('x').andThen(half).map(square).getError() ==
+                ResultCode_t::INVALID_PARAMETER &&
+            digit.map([](int value) { return std::to_string(value); })
+                    .getValue() == "7";
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Expected chains and maps\n";
+  } else {
+    std::cout << "[FAIL] Expected does not chain and map\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  // A failure is counted where it is created, not each time it is passed on
+  Result::ErrorStatistics     failuresBefore = Result::getErrorStatistics();
+  Expected<int, ResultCode_t> passed         = parseDigit('x');
+  for (int i = 0; i < 10; ++i)
+    passed = passed.andThen(half);
+  Expected<int>               converted = passed.map(square);
+  Result                      appended  = converted.getResult() + "Passed on";
+  Expected<int, ResultCode_t> back      = Expected<int>(appended);
+  matches = ResultCode_t::INVALID_PARAMETER == back.getResult() &&
+            ResultCode_t::INVALID_PARAMETER == converted.getError() &&
+            ResultCode_t::SUCCESS != passed.getResult();
+  size_t   i = static_cast<size_t>(ResultCode_t::INVALID_PARAMETER);
+  uint64_t counted =
+      Result::getErrorStatistics().counts[i] - failuresBefore.counts[i];
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  matches = matches && counted == 1;
+#else
+  matches = matches && counted == 0;
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Expected counts a failure once\n";
+  } else {
+    std::cout << "[FAIL] Expected does not count a failure once, counted "
+              << counted << "\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  Expected<std::unique_ptr<std::string>> owned(
+      std::unique_ptr<std::string>(new std::string("owned")));
+  Expected<std::unique_ptr<std::string>> moved = std::move(owned);
+  Expected<std::unique_ptr<std::string>> failed =
+      ResultCode_t::OPEN_FAILED + "No owner";
+  moved   = std::move(moved);
+  matches = moved && *moved.getValue() == "owned" && !failed;
+  failed  = std::move(moved);
+  matches = matches && failed && *failed.getValue() == "owned";
+  size_t length =
+      std::move(failed)
+          .map([](std::unique_ptr<std::string> && s) { return s->length(); })
+          .getValueOr(0);
+  Expected<std::string> text = std::string("copied");
+  Expected<std::string> copy = text;
+  copy                       = ResultCode_t::CRC;
+  copy                       = text;
+  matches = matches && length == 5 && copy && copy.getValue() == "copied";
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Expected moves and copies its value\n";
+  } else {
+    std::cout << "[FAIL] Expected does not move and copy its value\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  // A throwing copy leaves an error rather than the destroyed value
+  bool threw = false;
+  {
+    Expected<Tracked> target = Tracked();
+    Expected<Tracked> source = Tracked();
+    source.getValue().throwOnCopy = true;
+    try {
+      target = source;
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    matches = threw && !target &&
+              target.getError() == ResultCode_t::INVALID_STATE &&
+              Tracked::live == 1;
+  }
+  if (matches && Tracked::live == 0) {
+    if (printPass)
+      std::cout << "[PASS] Expected holds an error after a throwing copy\n";
+  } else {
+    std::cout << "[FAIL] Expected does not hold an error after a throwing "
+                 "copy, "
+              << Tracked::live << " live\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test the asynchronous result log
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testResultLog(bool printPass = true) {
+  // Without threads log writes on the calling thread, so there is one producer
+#ifdef FRUIT_BOWL_NO_THREADS
+  const int producers = 1;
+#else
+  const int producers = 4;
+#endif /* FRUIT_BOWL_NO_THREADS */
+  std::ostringstream    stream;
+  ResultLog::Statistics statistics;
+  std::string           flushed;
+  {
+    // A window longer than the test, so every repeat is still coalesced
+    ResultLog log(stream, 64 * 1024, std::chrono::hours(1));
+    auto      produce = [&log](int i) {
+      Result repeated = ResultCode_t::TIMEOUT + "Database did not respond";
+      for (int j = 0; j < 1000; ++j)
+        log.log(repeated);
+      log.log(ResultCode_t::OPEN_FAILED + ("thread " + std::to_string(i)));
+    };
+#ifdef FRUIT_BOWL_NO_THREADS
+    produce(0);
+#else
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; ++i)
+      threads.push_back(std::thread(produce, i));
+    for (std::thread & thread : threads)
+      thread.join();
+#endif /* FRUIT_BOWL_NO_THREADS */
+    log.flush();
+    statistics = log.getStatistics();
+    flushed    = stream.str();
+  }
+  std::string output  = stream.str();
+  bool        matches = statistics.logged == producers * 1001 &&
+                        statistics.dropped == 0 &&
+                        statistics.written == producers + 1 &&
+                        statistics.coalesced == producers * 1000 - 1 &&
+                        output.find("Database did not respond\n  ->repeated " +
+                                    std::to_string(producers * 1000 - 1) +
+                                    " times\n") != std::string::npos;
+  for (int i = 0; i < producers; ++i)
+    matches = matches && flushed.find("thread " + std::to_string(i) + "\n") !=
+                             std::string::npos;
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Result log removes repeats\n";
+  } else {
+    std::cout << "[FAIL] Result log does not remove repeats, "
+              << statistics.written << " written, " << statistics.coalesced
+              << " coalesced\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  // A full ring drops results rather than waiting
+  stream.str("");
+  const int attempts = 10000;
+  int       accepted = 0;
+  {
+    ResultLog log(stream, 2, std::chrono::milliseconds(0));
+    for (int i = 0; i < attempts; ++i)
+      accepted += log.log(ResultCode_t::INVALID_DATA + std::to_string(i));
+    statistics = log.getStatistics();
+  }
+  output  = stream.str();
+  matches = statistics.logged == static_cast<uint64_t>(accepted) &&
+            statistics.logged + statistics.dropped == attempts &&
+            statistics.coalesced == 0 &&
+            (statistics.dropped == 0) ==
+                (output.find("ResultLog dropped") == std::string::npos);
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Result log drops results when full, "
+                << statistics.dropped << " dropped\n";
+  } else {
+    std::cout << "[FAIL] Result log does not drop results when full\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+/**
+ * @brief Test sharing results and hashes between threads
+ *
+ * @param printPass will print when cases are passing if true, only fails if
+ * false
+ * @return Result
+ */
+Result testThreads(bool printPass = true) {
+#ifndef FRUIT_BOWL_NO_THREADS
+  const int                threadCount = 8;
+  std::vector<std::thread> threads;
+
+  Result shared = testRecursion(8);
+  Hash   sharedHash;
+  sharedHash.add("Shared between threads");
+
+  const int        copyCount = 100000;
+  std::atomic<int> mismatches(0);
+  for (int i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&]() {
+      for (int j = 0; j < copyCount; ++j) {
+        Result copy = shared;
+        Result assigned;
+        assigned  = copy;
+        Hash hash = sharedHash;
+        if (strcmp(assigned.getMessage(), shared.getMessage()) != 0 ||
+            hash.get() != sharedHash.get())
+          ++mismatches;
+      }
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+
+  if (mismatches == 0) {
+    if (printPass)
+      std::cout << "[PASS] Copies are consistent across threads\n";
+  } else {
+    std::cout << "[FAIL] Copies are not consistent across threads\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  if (shared.getReferenceCount() && *shared.getReferenceCount() == 1 &&
+      sharedHash.getReferenceCount() && *sharedHash.getReferenceCount() == 1) {
+    if (printPass)
+      std::cout << "[PASS] Reference count is 1 after threads complete\n";
+  } else {
+    std::cout << "[FAIL] Reference count is not 1 after threads complete\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+  shared = Result();
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+#ifndef FRUIT_BOWL_NO_THREADS
+  // Messages created on other threads are released on this one
+  Result::releaseMemory();
+  Result::MemoryStatistics before = Result::getMemoryStatistics();
+  std::vector<Result>      handed(threadCount * 1000);
+  threads.clear();
+  for (int i = 0; i < threadCount; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      for (int j = 0; j < 1000; ++j)
+        handed[i * 1000 + j] =
+            testRecursion(j % 8) + std::string(j % 300, 'x');
+    }));
+  }
+  for (std::thread & thread : threads)
+    thread.join();
+  Result::MemoryStatistics during = Result::getMemoryStatistics();
+  bool grew = during.inUse > before.inUse &&
+              during.highWater >= during.reserved &&
+              strlen(handed[299].getMessage()) > 299;
+  handed.clear();
+  Result::releaseMemory();
+  Result::MemoryStatistics after = Result::getMemoryStatistics();
+  if (grew && after.inUse == before.inUse &&
+      after.reserved == after.inUse && after.highWater >= during.reserved) {
+    if (printPass)
+      std::cout << "[PASS] Message memory is released across threads\n";
+  } else {
+    std::cout << "[FAIL] Message memory is not released across threads, "
+              << after.inUse << " B in use, " << after.reserved
+              << " B reserved, " << before.inUse << " B before\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+#endif /* FRUIT_BOWL_NO_THREADS */
+
+  // Failures of exited threads are kept, copies and appends are not counted.
+  // Without threads they are only created on this one.
+  auto fail = []() {
+    for (int j = 0; j < 1000; ++j) {
+      Result failure  = ResultCode_t::TIMEOUT;
+      Result appended = failure + "Retrying";
+      Result copy     = appended;
+      failure         = ResultCode_t::SUCCESS;
+    }
+  };
+  Result::ErrorStatistics failuresBefore = Result::getErrorStatistics();
+#ifdef FRUIT_BOWL_NO_THREADS
+  const int producers = 1;
+  fail();
+#else
+  const int producers = threadCount;
+  threads.clear();
+  for (int i = 0; i < producers; ++i)
+    threads.push_back(std::thread(fail));
+  for (std::thread & thread : threads)
+    thread.join();
+#endif /* FRUIT_BOWL_NO_THREADS */
+  Result                  local         = ResultCode_t::DISK_FULL + "Full";
+  Result::ErrorStatistics failuresAfter = Result::getErrorStatistics();
+  auto                    counted       = [&](ResultCode_t code) {
+    size_t i = static_cast<size_t>(code);
+    return failuresAfter.counts[i] - failuresBefore.counts[i];
+  };
+  uint64_t           timeouts = counted(ResultCode_t::TIMEOUT);
+  uint64_t           diskFull = counted(ResultCode_t::DISK_FULL);
+  std::ostringstream labelled;
+  labelled << failuresAfter;
+#ifdef FRUIT_BOWL_RESULT_TELEMETRY
+  bool matches = timeouts == producers * 1000 && diskFull == 1 &&
+                 failuresAfter.counts[0] == 0 &&
+                 labelled.str().find(Results::MESSAGES[static_cast<size_t>(
+                     ResultCode_t::TIMEOUT)]) != std::string::npos;
+#else
+  bool matches = timeouts == 0 && diskFull == 0 && labelled.str().empty();
+#endif /* FRUIT_BOWL_RESULT_TELEMETRY */
+  if (matches) {
+    if (printPass)
+      std::cout << "[PASS] Failures are counted across threads\n";
+  } else {
+    std::cout << "[FAIL] Failures are not counted across threads, " << timeouts
+              << " timeouts of " << producers * 1000 << "\n";
+    return ResultCode_t::INVALID_STATE;
+  }
+
+  return ResultCode_t::SUCCESS;
+}
+
+int main() {
+  std::cout << "Testing FruitBowl\n";
+  Result result = testResult(true);
+  if (!result)
+    std::cout << "[FAIL] *** Result class does not pass ***\n";
+
+  // while (true)
+  //   result = testResult(false);
+
+  result = testHash(true);
+  if (!result)
+    std::cout << "[FAIL] *** Hash class does not pass ***\n";
+
+  result = testLiteHash(true);
+  if (!result)
+    std::cout << "[FAIL] *** LiteHash class does not pass ***\n";
+
+  result = testHashMap(true);
+  if (!result)
+    std::cout << "[FAIL] *** HashMap class does not pass ***\n";
+
+  result = testInternTable(true);
+  if (!result)
+    std::cout << "[FAIL] *** InternTable class does not pass ***\n";
+
+  result = testPerfectHash(true);
+  if (!result)
+    std::cout << "[FAIL] *** PerfectHash class does not pass ***\n";
+
+  result = testTokenizer(true);
+  if (!result)
+    std::cout << "[FAIL] *** Tokenizer class does not pass ***\n";
+
+  result = testUTF8(true);
+  if (!result)
+    std::cout << "[FAIL] *** UTF8 validation does not pass ***\n";
+
+  result = testCRC32C(true);
+  if (!result)
+    std::cout << "[FAIL] *** CRC32C class does not pass ***\n";
+
+  result = testFile(true);
+  if (!result)
+    std::cout << "[FAIL] *** File hashing does not pass ***\n";
+
+  result = testChunker(true);
+  if (!result)
+    std::cout << "[FAIL] *** Chunker class does not pass ***\n";
+
+  result = testBloomFilter(true);
+  if (!result)
+    std::cout << "[FAIL] *** BloomFilter class does not pass ***\n";
+
+  result = testHashIndex(true);
+  if (!result)
+    std::cout << "[FAIL] *** HashIndex class does not pass ***\n";
+
+  result = testHashAlgorithms(true);
+  if (!result)
+    std::cout << "[FAIL] *** Hash algorithms do not pass ***\n";
+
+  result = testExpected(true);
+  if (!result)
+    std::cout << "[FAIL] *** Expected class does not pass ***\n";
+
+  result = testResultLog(true);
+  if (!result)
+    std::cout << "[FAIL] *** ResultLog class does not pass ***\n";
+
+  result = testThreads(true);
+  if (!result)
+    std::cout << "[FAIL] *** Thread sharing does not pass ***\n";
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <FruitBowl.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Build a HashIndex file from lines of "key\tpayload"
+ * A line without a tab is a key with an empty payload, a repeated key keeps
+ * its last payload
+ *
+ * @param argc number of arguments
+ * @param argv input text file and output index file
+ * @return int 0 on success
+ */
+int main(int argc, char * argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: FruitBowl-HashIndex <input.txt> <output.bin>\n";
+    return 1;
+  }
+
+  std::ifstream input(argv[1], std::ios::binary);
+  if (!input) {
+    std::cout << "Could not open " << argv[1] << "\n";
+    return 1;
+  }
+
+  HashIndexBuilder builder;
+  std::string      line;
+  Result           result = ResultCode_t::SUCCESS;
+  while (result && std::getline(input, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    size_t tab = line.find('\t');
+    if (tab == std::string::npos)
+      result = builder.add(line, std::string());
+    else
+      result = builder.add(line.substr(0, tab), line.substr(tab + 1));
+  }
+
+  if (result)
+    result = builder.write(argv[2]);
+  if (!result) {
+    std::cout << result.getMessage() << "\n";
+    return 1;
+  }
+
+  HashIndex index;
+  result = index.open(argv[2]);
+  std::cout << "Wrote " << index.size() << " keys to " << argv[2] << "\n";
+  return result ? 0 : 1;
+}